@@ -0,0 +1,52 @@
+/*
+  bench.h
+
+  Timing and synthetic trees for the host benchmarks.
+*/
+
+#ifndef EMBEDFS_HOST_BENCH_H
+#define EMBEDFS_HOST_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static inline double nowUs()
+{
+    using namespace std::chrono;
+    return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Percentile p (0-100) of samples, which are sorted in place
+static inline double percentile(std::vector<double> &samples, double p)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[std::min(samples.size() - 1, static_cast<size_t>(samples.size() * p / 100))];
+}
+
+// count files below dirs directories: "/dNN/fNNNNN.bin" with sizes in [min_size, max_size]
+struct SyntheticTree
+{
+    std::vector<std::string> paths;
+    std::vector<std::string> data;
+
+    SyntheticTree(size_t count, size_t min_size, size_t max_size, size_t dirs = 40)
+    {
+        std::mt19937 rng(1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            char path[32];
+            snprintf(path, sizeof(path), "/d%02u/f%05u.bin", static_cast<unsigned>(i % dirs), static_cast<unsigned>(i));
+            paths.push_back(path);
+            std::string bytes(min_size + rng() % (max_size - min_size + 1), '\0');
+            for (char &c : bytes)
+                c = static_cast<char>(rng());
+            data.push_back(bytes);
+        }
+    }
+};
+
+#endif // EMBEDFS_HOST_BENCH_H
@@ -0,0 +1,93 @@
+/*
+  bench_handle.cpp
+
+  Per-byte loops over a 1 MB text file through File and through EmbedFSHandle: plain
+  single-byte read(), and a tokenizer that peeks, reads and calls readUntil() per line.
+*/
+
+#include "bench.h"
+
+#include <EmbedFS.h>
+
+using namespace fs;
+
+// Sum of the bytes, one read() at a time
+template <typename Reader>
+static uint32_t byteLoop(Reader &r)
+{
+    uint32_t sum = 0;
+    for (int c; (c = r.read()) >= 0;)
+        sum += static_cast<uint32_t>(c);
+    return sum;
+}
+
+// Lines starting with '#' are skipped byte by byte, the others taken with readUntil()
+static size_t tokenize(File &f)
+{
+    size_t tokens = 0;
+    char line[128];
+    while (f.available())
+    {
+        if (f.peek() == '#')
+        {
+            while (f.available() && f.read() != '\n')
+                ;
+            continue;
+        }
+        tokens += f.readBytesUntil('\n', line, sizeof(line)) > 0;
+    }
+    return tokens;
+}
+
+static size_t tokenize(EmbedFSHandle &h)
+{
+    size_t tokens = 0;
+    char line[128];
+    while (h.available())
+    {
+        if (h.peek() == '#')
+        {
+            while (h.available() && h.read() != '\n')
+                ;
+            continue;
+        }
+        tokens += h.readUntil('\n', line, sizeof(line)) > 0;
+    }
+    return tokens;
+}
+
+int main()
+{
+    std::string text;
+    for (int i = 0; text.size() < (1u << 20); ++i)
+        text += (i % 4 == 0) ? "# comment line to skip\n" : "key" + std::to_string(i) + " = value " + std::to_string(i * 7) + "\n";
+    const char *names[] = {"/config.txt"};
+    const uint8_t *data[] = {reinterpret_cast<const uint8_t *>(text.data())};
+    size_t sizes[] = {text.size()};
+    EmbedFSFS efs;
+    efs.begin(names, data, sizes, 1);
+
+    printf("%zu bytes\n", text.size());
+    File f = efs.open("/config.txt");
+    double t0 = nowUs();
+    uint32_t a = byteLoop(f);
+    double file = nowUs() - t0;
+    EmbedFSHandle h = efs.openHandle("/config.txt");
+    t0 = nowUs();
+    uint32_t b = byteLoop(h);
+    double handle = nowUs() - t0;
+    printf("  read() per byte:  File %.2f ns/byte, handle %.2f ns/byte%s\n", file * 1000 / text.size(),
+           handle * 1000 / text.size(), a == b ? "" : " MISMATCH");
+
+    f = efs.open("/config.txt");
+    t0 = nowUs();
+    size_t x = tokenize(f);
+    file = nowUs() - t0;
+    h = efs.openHandle("/config.txt");
+    t0 = nowUs();
+    size_t y = tokenize(h);
+    handle = nowUs() - t0;
+    printf("  tokenizer:        File %.2f ns/byte, handle %.2f ns/byte%s\n", file * 1000 / text.size(),
+           handle * 1000 / text.size(), x == y ? "" : " MISMATCH");
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+  bench_index.cpp
+
+  Path index modes on 20,000 files mounted as arrays: begin() time, then the first and the
+  p50/p99 of 2,000 random exists() lookups right after begin(). Then a persisted index
+  (writeIndex()/setIndexCache()) adopted by begin() against an eager rebuild, for the arrays
+  (key hashed from the names) and for the same tree as a packed image (key recorded by the
+  generator as EmbedFSImage::nameDigest).
+*/
+
+#include "bench.h"
+
+#include <EmbedFS.h>
+
+using namespace fs;
+
+struct Mount
+{
+    std::vector<const char *> names;
+    std::vector<const uint8_t *> data;
+    std::vector<size_t> sizes;
+
+    explicit Mount(const SyntheticTree &tree)
+    {
+        for (size_t i = 0; i < tree.paths.size(); ++i)
+        {
+            names.push_back(tree.paths[i].c_str());
+            data.push_back(reinterpret_cast<const uint8_t *>(tree.data[i].data()));
+            sizes.push_back(tree.data[i].size());
+        }
+    }
+    bool begin(EmbedFSFS &efs) { return efs.begin(names.data(), data.data(), sizes.data(), names.size()); }
+};
+
+// The tree as a packed image: 1-byte blob entries, a skip pair every 16 and the name
+// digest computed the way tools/embed_assets.py does
+struct PackedMount
+{
+    std::vector<const char *> names;
+    std::string blob;
+    std::vector<uint8_t> toc;
+    std::vector<uint32_t> skip;
+    EmbedFSImage image;
+
+    explicit PackedMount(const SyntheticTree &tree)
+    {
+        uint64_t digest = 0xCBF29CE484222325ull ^ tree.paths.size();
+        for (size_t i = 0; i < tree.paths.size(); ++i)
+        {
+            names.push_back(tree.paths[i].c_str());
+            for (const char *c = names.back();; ++c)
+            {
+                digest = (digest ^ static_cast<uint8_t>(*c)) * 0x100000001B3ull;
+                if (!*c)
+                    break;
+            }
+            if (i % 16 == 0)
+            {
+                skip.push_back(static_cast<uint32_t>(toc.size()));
+                skip.push_back(static_cast<uint32_t>(blob.size()));
+            }
+            toc.push_back(static_cast<uint8_t>(tree.data[i].size() << EMBEDFS_TOC_FLAG_BITS)); // sizes < 16
+            blob += tree.data[i];
+        }
+        uint32_t count = static_cast<uint32_t>(names.size());
+        image = EmbedFSImage{EMBEDFS_IMAGE_VERSION, count, names.data(),
+                             reinterpret_cast<const uint8_t *>(blob.data()), toc.data(), skip.data(), 16,
+                             count, nullptr, 0, nullptr, 0, nullptr, 0, nullptr, nullptr, nullptr, 0,
+                             nullptr, nullptr, 0, nullptr, nullptr, digest};
+    }
+    bool begin(EmbedFSFS &efs) { return efs.begin(image); }
+};
+
+// begin() adopting a blob saved by writeIndex() against an eager rebuild
+template <class M>
+static void persisted(const char *label, M &mount)
+{
+    EmbedFSFS efs;
+    efs.setIndex(IndexEager);
+    mount.begin(efs);
+    StringPrint blob;
+    efs.writeIndex(blob);
+    efs.end();
+    double t0 = nowUs();
+    mount.begin(efs);
+    double rebuild = nowUs() - t0;
+    efs.end();
+    efs.setIndexCache(reinterpret_cast<const uint8_t *>(blob.out.data()), blob.out.size());
+    t0 = nowUs();
+    mount.begin(efs);
+    double adopt = nowUs() - t0;
+    printf("  persisted index, %-6s (%zu bytes): begin %.1f us adopting vs %.1f us rebuilding, ready %d\n", label,
+           blob.out.size(), adopt, rebuild, efs.indexReady());
+}
+
+int main()
+{
+    SyntheticTree tree(20000, 1, 1);
+    Mount mount(tree);
+    std::mt19937 rng(3);
+    std::vector<size_t> order(2000);
+    for (size_t &i : order)
+        i = rng() % tree.paths.size();
+
+    printf("%zu files, %zu random lookups after begin()\n", tree.paths.size(), order.size());
+    const IndexMode modes[] = {IndexOff, IndexEager, IndexLazy, IndexBackground};
+    const char *const labels[] = {"off", "eager", "lazy", "background"};
+    for (size_t m = 0; m < 4; ++m)
+    {
+        EmbedFSFS efs;
+        efs.setIndex(modes[m]);
+        double t0 = nowUs();
+        mount.begin(efs);
+        double begin = nowUs() - t0;
+        std::vector<double> samples;
+        size_t found = 0;
+        for (size_t i : order)
+        {
+            t0 = nowUs();
+            found += efs.exists(tree.paths[i].c_str());
+            samples.push_back(nowUs() - t0);
+        }
+        double first = samples[0];
+        printf("  %-10s begin %8.1f us, first %7.2f us, p50 %6.2f us, p99 %6.2f us (%zu found)\n", labels[m], begin, first,
+               percentile(samples, 50), percentile(samples, 99), found);
+    }
+
+    persisted("arrays", mount);
+    PackedMount packed(tree);
+    persisted("packed", packed);
+    return 0;
+}
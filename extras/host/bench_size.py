@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+"""Flash taken by the same tree as generated arrays and as a packed image.
+
+8,000 files of 100-300 bytes (a tiny-file-heavy tree), generated with
+tools/embed_assets.py --report for a 32-bit target; prints the flash categories of both
+reports and the difference. Usage: bench_size.py [FILE_COUNT]
+"""
+
+from __future__ import annotations
+
+import json
+import pathlib
+import random
+import subprocess
+import sys
+import tempfile
+
+GENERATOR = pathlib.Path(__file__).resolve().parent.parent.parent / "tools" / "embed_assets.py"
+
+
+def report(root: pathlib.Path, fmt: str) -> dict:
+    out = root / f"{fmt}.json"
+    subprocess.run(
+        [sys.executable, str(GENERATOR), str(root / "assets"), "-o", str(root / f"{fmt}.h"), "--format", fmt,
+         "--no-cache", "--report", str(out)],
+        check=True,
+        stdout=subprocess.DEVNULL,
+    )
+    return json.loads(out.read_text(encoding="utf-8"))["flash"]
+
+
+def main() -> None:
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 8000
+    rng = random.Random(1)
+    with tempfile.TemporaryDirectory() as tmp:
+        root = pathlib.Path(tmp)
+        for i in range(count):
+            path = root / "assets" / f"d{i % 40:02d}" / f"f{i:05d}.bin"
+            path.parent.mkdir(parents=True, exist_ok=True)
+            path.write_bytes(bytes(rng.randrange(256) for _ in range(rng.randrange(100, 301))))
+        rows = {fmt: report(root, fmt) for fmt in ("arrays", "packed")}
+    print(f"{count} files of 100-300 bytes, 32-bit target")
+    for fmt, flash in rows.items():
+        print(
+            f"  {fmt:7} total {flash['total']:8} B  data {flash['data']:8}  padding {flash['padding']:6}  "
+            f"names {flash['names']:7}  index {flash['index']:7}"
+        )
+    print(f"  saved   {rows['arrays']['total'] - rows['packed']['total']} B")
+
+
+if __name__ == "__main__":
+    main()
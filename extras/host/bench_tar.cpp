@@ -0,0 +1,89 @@
+/*
+  bench_tar.cpp
+
+  beginTar() against mounting the same files as generated arrays: mount time, then
+  open() and a 64-byte read of every file in random order (no path index, so both scan
+  the names). 2,000 files of 512-1,536 bytes, archive built in memory.
+*/
+
+#include "bench.h"
+
+#include <EmbedFS.h>
+
+using namespace fs;
+
+// ustar header for a regular file
+static void tarHeader(std::string &tar, const std::string &path, size_t size)
+{
+    char h[512] = {};
+    snprintf(h, 100, "%s", path.c_str() + 1);
+    snprintf(h + 100, 8, "%07o", 0644);
+    snprintf(h + 108, 8, "%07o", 0);
+    snprintf(h + 116, 8, "%07o", 0);
+    snprintf(h + 124, 12, "%011o", static_cast<unsigned>(size));
+    snprintf(h + 136, 12, "%011o", 0);
+    h[156] = '0';
+    memcpy(h + 257, "ustar\0" "00", 8);
+    memset(h + 148, ' ', 8);
+    unsigned sum = 0;
+    for (unsigned char c : h)
+        sum += c;
+    snprintf(h + 148, 8, "%06o", sum);
+    tar.append(h, sizeof(h));
+}
+
+static void openAll(EmbedFSFS &efs, const SyntheticTree &tree, const char *label)
+{
+    std::vector<size_t> order(tree.paths.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(2));
+    uint8_t buf[64];
+    size_t bytes = 0;
+    double t0 = nowUs();
+    for (size_t i : order)
+    {
+        File f = efs.open(tree.paths[i].c_str());
+        bytes += f.read(buf, sizeof(buf));
+    }
+    double t = nowUs() - t0;
+    printf("  %-7s open + 64-byte read %.2f us per file (%zu bytes)\n", label, t / order.size(), bytes);
+}
+
+int main()
+{
+    SyntheticTree tree(2000, 512, 1536);
+    std::string tar;
+    std::vector<size_t> offsets;
+    for (size_t i = 0; i < tree.paths.size(); ++i)
+    {
+        tarHeader(tar, tree.paths[i], tree.data[i].size());
+        offsets.push_back(tar.size());
+        tar += tree.data[i];
+        tar.append((512 - tree.data[i].size() % 512) % 512, '\0');
+    }
+    tar.append(1024, '\0');
+    const uint8_t *archive = reinterpret_cast<const uint8_t *>(tar.data());
+
+    std::vector<const char *> names;
+    std::vector<const uint8_t *> data;
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i < tree.paths.size(); ++i)
+    {
+        names.push_back(tree.paths[i].c_str());
+        data.push_back(archive + offsets[i]);
+        sizes.push_back(tree.data[i].size());
+    }
+
+    printf("%zu files, archive %zu bytes\n", tree.paths.size(), tar.size());
+    EmbedFSFS efs;
+    double t0 = nowUs();
+    bool ok = efs.beginTar(archive, tar.size());
+    printf("  beginTar() %.1f us%s\n", nowUs() - t0, ok ? "" : " FAILED");
+    openAll(efs, tree, "tar");
+    t0 = nowUs();
+    ok = efs.begin(names.data(), data.data(), sizes.data(), names.size());
+    printf("  begin(arrays) %.1f us%s\n", nowUs() - t0, ok ? "" : " FAILED");
+    openAll(efs, tree, "arrays");
+    return 0;
+}
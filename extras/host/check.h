@@ -0,0 +1,135 @@
+/*
+  check.h
+
+  Minimal checks for the host tests: CHECK() reports the failing expression and the test
+  keeps going; checkDone() prints the verdict and returns the exit status. Fixture files
+  are read from FIXTURE_DIR (the Makefile's build directory, see fixtures.py).
+*/
+
+#ifndef EMBEDFS_HOST_CHECK_H
+#define EMBEDFS_HOST_CHECK_H
+
+#include <EmbedFS.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static int checkFailures = 0;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if (!(cond))                                                                 \
+        {                                                                            \
+            ++checkFailures;                                                         \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        }                                                                            \
+    } while (0)
+
+static inline int checkDone(const char *test)
+{
+    printf("%s: %s\n", test, checkFailures ? "FAIL" : "ok");
+    return checkFailures ? 1 : 0;
+}
+
+// Contents of FIXTURE_DIR/name, "" when missing
+static inline std::string fixtureFile(const std::string &name)
+{
+    std::string bytes;
+    FILE *f = fopen((std::string(FIXTURE_DIR "/") + name).c_str(), "rb");
+    if (!f)
+        return bytes;
+    char buf[4096];
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;)
+        bytes.append(buf, n);
+    fclose(f);
+    return bytes;
+}
+
+// Original bytes of an asset, by its path in the image ("/css/site.css")
+static inline std::string assetBytes(const char *path) { return fixtureFile(std::string("assets") + path); }
+
+static inline std::string readAll(fs::File &file)
+{
+    std::string bytes;
+    uint8_t buf[97]; // odd size: reads straddle extents, blocks and inflate output
+    for (size_t n; (n = file.read(buf, sizeof(buf))) > 0;)
+        bytes.append(reinterpret_cast<char *>(buf), n);
+    return bytes;
+}
+
+static inline std::string readAll(fs::EmbedFSReader &reader)
+{
+    std::string bytes;
+    uint8_t buf[97];
+    for (size_t n; (n = reader.read(buf, sizeof(buf))) > 0;)
+        bytes.append(reinterpret_cast<char *>(buf), n);
+    return bytes;
+}
+
+// Value of key in the "flash" object of a --report file fixtures.py wrote, or SIZE_MAX
+static inline size_t reportFlash(const std::string &report, const char *key)
+{
+    size_t at = report.find(std::string("\"") + key + "\":", report.find("\"flash\""));
+    return at == std::string::npos ? SIZE_MAX : strtoul(report.c_str() + at + strlen(key) + 3, nullptr, 10);
+}
+
+// footprint() of a mounted fixture against the generator's report (flash by category) and
+// the mounted names (with their pointers unless the names live in RAM), the open-File
+// figures while one file is open, and the writeFootprint() keys
+static inline void checkFootprint(fs::EmbedFSFS &efs, const char *report, bool pointers)
+{
+    const std::string json = fixtureFile(report);
+    fs::EmbedFSFootprint fp = efs.footprint();
+    CHECK(fp.fileData == reportFlash(json, "data"));
+    CHECK(fp.padding == reportFlash(json, "padding"));
+    CHECK(fp.names == reportFlash(json, "names"));
+    CHECK(fp.index == reportFlash(json, "index"));
+    CHECK(fp.flash() == reportFlash(json, "total"));
+    if (efs.core()->fileNames())
+    {
+        size_t names = 0;
+        for (size_t i = 0; i < efs.core()->fileCount(); ++i)
+            names += strlen(efs.core()->fileName(i)) + 1 + (pointers ? sizeof(const char *) : 0);
+        CHECK(fp.names == names);
+    }
+
+    fs::File file = efs.open("/docs/guide.txt");
+    fs::EmbedFSFootprint open = efs.footprint();
+    CHECK(open.openFiles == fp.openFiles + 1 && open.files > fp.files && open.ram() > fp.ram());
+    file.close();
+    fs::EmbedFSFootprint closed = efs.footprint();
+    CHECK(closed.openFiles == fp.openFiles && closed.files == fp.files && closed.ram() == fp.ram());
+
+    static const char *const keys[] = {"flash.data", "flash.padding", "flash.names", "flash.index", "flash.total",
+                                       "ram.lookup", "ram.mount",     "ram.cache",   "ram.preload", "ram.engine",
+                                       "ram.files",  "ram.slots",     "ram.dirs",    "ram.inflate", "ram.total",
+                                       "open.files", "open.dirs"};
+    StringPrint out;
+    CHECK(efs.writeFootprint(out) == sizeof(keys) / sizeof(keys[0]));
+    size_t at = 0;
+    for (const char *key : keys)
+    {
+        CHECK(out.out.compare(at, strlen(key) + 1, std::string(key) + " ") == 0);
+        at = out.out.find("\r\n", at);
+        if (at == std::string::npos)
+            break;
+        at += 2;
+    }
+    CHECK(at == out.out.size());
+    CHECK(out.out.find("flash.data " + std::to_string(fp.fileData) + "\r\n") == 0);
+}
+
+// Every file of the fixture tree, by image path
+static const char *const fixturePaths[] = {
+    "/app.js",          "/bin/sparse.bin",      "/css/site.css",        "/docs/guide.txt",
+    "/docs/index.html", "/index.html",          "/sounds/beep.raw",     "/sounds/click.raw",
+    "/theme/base/font.txt", "/theme/base/logo.svg", "/theme/dark/logo.svg", "/tiny/a.txt",
+    "/tiny/b.txt",
+};
+static const size_t fixturePathCount = sizeof(fixturePaths) / sizeof(fixturePaths[0]);
+
+#endif // EMBEDFS_HOST_CHECK_H
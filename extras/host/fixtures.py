@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""Write the host test fixtures into a build directory.
+
+An asset tree covering every entry kind (aliases, inline, sparse, default documents,
+search roots, tags, preload), the headers, device image and footprint reports
+tools/embed_assets.py makes from it, and a tar and a ZIP of the same tree, so no
+generated or binary file is committed. With --bench, writes the layout benchmark images instead: 2,000 files packed
+in path order and laid out by an access profile of four scattered files.
+Usage: fixtures.py [--bench] BUILD_DIR
+"""
+
+from __future__ import annotations
+
+import io
+import json
+import pathlib
+import random
+import subprocess
+import sys
+import tarfile
+import zipfile
+
+HERE = pathlib.Path(__file__).resolve().parent
+GENERATOR = HERE.parent.parent / "tools" / "embed_assets.py"
+
+# The tests read these files back as the expected bytes (assetBytes() in check.h); keep
+# the paths in sync with fixturePaths there
+FILES = {
+    "index.html": "<!doctype html><title>EmbedFS</title><p>index page</p>\n" * 4,
+    "app.js": "function main(){console.log('embedfs');}\nmain();\n" * 6,
+    "css/site.css": "body { color: #333; }\na[href*=\"x;y\"] { content: \"{ ; }\"; }\n" * 3,
+    "docs/index.html": "<h1>docs</h1>\n" * 8,
+    "docs/guide.txt": "line of the guide\n" * 20,
+    "tiny/a.txt": "A",
+    "tiny/b.txt": "bb",
+    "theme/dark/logo.svg": "<svg>dark</svg>" * 4,
+    "theme/base/logo.svg": "<svg>base</svg>" * 4,
+    "theme/base/font.txt": "base font metrics\n" * 5,
+    "sounds/beep.raw": "beep" * 40,
+    "sounds/click.raw": "click" * 40,
+}
+
+MANIFEST = {
+    "aliases": {"/app": "/index.html", "/tiny/c.txt": "/tiny/b.txt"},
+    "preload": ["css/*", "tiny/a.txt"],
+    "tags": {"web": ["*.html", "*.js", "css/*"], "sounds": "sounds/*", "tiny": "tiny/*"},
+}
+
+
+def sparse_bytes() -> bytes:
+    """8 KB, mostly zero: a head, a middle and a tail extent."""
+    data = bytearray(8192)
+    data[0:4] = b"HEAD"
+    data[4000:4016] = bytes(range(1, 17))
+    data[-4:] = b"TAIL"
+    return bytes(data)
+
+
+def write_tree(root: pathlib.Path) -> None:
+    for path, text in FILES.items():
+        target = root / path
+        target.parent.mkdir(parents=True, exist_ok=True)
+        target.write_text(text, encoding="utf-8")
+    (root / "bin").mkdir(exist_ok=True)
+    (root / "bin" / "sparse.bin").write_bytes(sparse_bytes())
+
+
+def generate(build: pathlib.Path, output: str, *args: str, assets: str = "assets") -> None:
+    command = [sys.executable, str(GENERATOR), str(build / assets), "-o", str(build / output), "--no-cache", "-j", "1"]
+    subprocess.run(command + list(args), check=True, stdout=subprocess.DEVNULL)
+
+
+def report(build: pathlib.Path, name: str) -> list[str]:
+    """Options writing the footprint report checkFootprint() compares with (64-bit host pointers)."""
+    return ["--report", str(build / f"footprint_{name}.json"), "--pointer-size", "8"]
+
+
+# Files bench_layout reads, in this order; keep in sync with bench_layout.cpp
+LAYOUT_HOT = ["d03/f00123.bin", "d17/f00777.bin", "d29/f01309.bin", "d38/f01958.bin"]
+
+
+def write_layout_fixtures(build: pathlib.Path) -> None:
+    """2,000 files of 100-600 bytes, packed plain and with a profile of LAYOUT_HOT."""
+    rng = random.Random(1)
+    root = build / "layout"
+    for i in range(2000):
+        path = root / f"d{i % 40:02d}" / f"f{i:05d}.bin"
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_bytes(bytes(rng.randrange(256) for _ in range(rng.randrange(100, 601))))
+    profile = build / "layout_profile.txt"
+    profile.write_text("".join(f"20 /{path}\n" for path in LAYOUT_HOT), encoding="utf-8")
+    generate(build, "layout_plain.h", "--prefix", "plain", "--format", "packed", assets="layout")
+    generate(build, "layout_profiled.h", "--prefix", "hot", "--format", "packed", "--profile", str(profile),
+             assets="layout")
+
+
+def write_tar(build: pathlib.Path) -> None:
+    with tarfile.open(build / "assets.tar", "w", format=tarfile.USTAR_FORMAT) as tar:
+        for path in sorted((build / "assets").rglob("*")):
+            if path.is_file():
+                tar.add(path, arcname=path.relative_to(build / "assets").as_posix())
+
+
+def write_zip(build: pathlib.Path) -> None:
+    """Text files deflated, the rest stored."""
+    with zipfile.ZipFile(build / "assets.zip", "w") as archive:
+        for path in sorted((build / "assets").rglob("*")):
+            if path.is_file():
+                name = path.relative_to(build / "assets").as_posix()
+                method = zipfile.ZIP_STORED if name.endswith((".bin", ".raw")) else zipfile.ZIP_DEFLATED
+                archive.write(path, name, compress_type=method)
+
+
+def main() -> None:
+    args = sys.argv[1:]
+    bench = args[:1] == ["--bench"]
+    if len(args) != 1 + bench:
+        sys.exit(__doc__)
+    build = pathlib.Path(args[-1])
+    if bench:
+        write_layout_fixtures(build)
+        return
+    write_tree(build / "assets")
+    (build / "manifest.json").write_text(json.dumps(MANIFEST, indent=2), encoding="utf-8")
+    (build / "aliases.json").write_text(json.dumps({"aliases": MANIFEST["aliases"]}), encoding="utf-8")
+    manifest = ["--manifest", str(build / "manifest.json")]
+
+    generate(build, "fixture_arrays.h", "--prefix", "arr", "--manifest", str(build / "aliases.json"), *report(build, "arrays"))
+    generate(build, "fixture_packed.h", "--prefix", "pk", "--format", "packed", "--sparse-min-run", "64",
+             "--content-hash", *manifest, *report(build, "packed"))
+    generate(build, "fixture_names.h", "--prefix", "fc", "--format", "packed", "--name-blocks", "4", *manifest,
+             *report(build, "names"))
+    generate(build, "fixture_asm_arrays.h", "--prefix", "asa", "--emit", "asm", "--pointer-size", "8",
+             "--manifest", str(build / "aliases.json"))
+    generate(build, "fixture_asm_packed.h", "--prefix", "asp", "--format", "packed", "--emit", "asm",
+             "--pointer-size", "8", "--manifest", str(build / "aliases.json"))
+    generate(build, "fixture.img", "--format", "packed", "--emit", "image", "--inline-max", "32", "--skip-interval", "4",
+             "--manifest", str(build / "aliases.json"), *report(build, "device"))
+    write_tar(build)
+    write_zip(build)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,79 @@
+/*
+  Arduino.h (host shim)
+
+  The few Arduino types the EmbedFS adapter uses (String, Print, Stream), so EmbedFS.cpp
+  builds and runs on the host for extras/host tests and benchmarks. ARDUINO stays
+  undefined: the engine picks its host policy (EmbedFSPolicy.h).
+*/
+
+#ifndef EMBEDFS_HOST_ARDUINO_H
+#define EMBEDFS_HOST_ARDUINO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+typedef bool boolean;
+
+class String
+{
+public:
+    String(const char *s = "") : s_(s ? s : "") {}
+    const char *c_str() const { return s_.c_str(); }
+    size_t length() const { return s_.size(); }
+    bool operator==(const char *s) const { return s_ == s; }
+
+private:
+    std::string s_;
+};
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size)
+    {
+        size_t n = 0;
+        while (n < size && write(buf[n]))
+            ++n;
+        return n;
+    }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    // Without Arduino's timeout: stops at the end of the stream
+    size_t readBytesUntil(char terminator, char *buffer, size_t length)
+    {
+        size_t n = 0;
+        for (int c; n < length && (c = read()) >= 0 && c != terminator;)
+            buffer[n++] = static_cast<char>(c);
+        return n;
+    }
+};
+
+// Print into a std::string, for writeIndex()/writeProfile()/writeFootprint()
+class StringPrint : public Print
+{
+public:
+    size_t write(uint8_t c) override
+    {
+        out.push_back(static_cast<char>(c));
+        return 1;
+    }
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        out.append(reinterpret_cast<const char *>(buf), size);
+        return size;
+    }
+    std::string out;
+};
+
+#endif // EMBEDFS_HOST_ARDUINO_H
@@ -0,0 +1,59 @@
+/*
+  FS.cpp (host shim): File and FS forward to FileImpl/FSImpl like the arduino-esp32 FS
+  library.
+*/
+
+#include "FSImpl.h"
+
+using namespace fs;
+
+int File::available() { return _p ? static_cast<int>(_p->size() - _p->position()) : 0; }
+
+int File::read()
+{
+    uint8_t b;
+    return (_p && _p->read(&b, 1) == 1) ? b : -1;
+}
+
+int File::peek()
+{
+    if (!_p)
+        return -1;
+    size_t pos = _p->position();
+    int b = read();
+    _p->seek(pos, SeekSet);
+    return b;
+}
+
+size_t File::read(uint8_t *buf, size_t size) { return _p ? _p->read(buf, size) : 0; }
+bool File::seek(uint32_t pos, SeekMode mode) { return _p && _p->seek(pos, mode); }
+size_t File::position() const { return _p ? _p->position() : 0; }
+size_t File::size() const { return _p ? _p->size() : 0; }
+
+void File::close()
+{
+    if (_p)
+        _p->close();
+    _p = nullptr;
+}
+
+File::operator bool() const { return _p && *_p; }
+const char *File::path() const { return _p ? _p->path() : nullptr; }
+const char *File::name() const { return _p ? _p->name() : nullptr; }
+boolean File::isDirectory(void) { return _p && _p->isDirectory(); }
+File File::openNextFile(const char *mode) { return _p ? File(_p->openNextFile(mode)) : File(); }
+String File::getNextFileName(void) { return _p ? _p->getNextFileName() : String(); }
+String File::getNextFileName(bool *isDir) { return _p ? _p->getNextFileName(isDir) : String(); }
+
+void File::rewindDirectory(void)
+{
+    if (_p)
+        _p->rewindDirectory();
+}
+
+File FS::open(const char *path, const char *mode, const bool create)
+{
+    return _impl ? File(_impl->open(path, mode, create)) : File();
+}
+
+bool FS::exists(const char *path) { return _impl && _impl->exists(path); }
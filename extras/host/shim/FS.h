@@ -0,0 +1,75 @@
+/*
+  FS.h (host shim): fs::File and fs::FS of the arduino-esp32 FS library, reduced to what
+  EmbedFS and its host tests use.
+*/
+
+#ifndef EMBEDFS_HOST_FS_H
+#define EMBEDFS_HOST_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+namespace fs
+{
+
+    enum SeekMode
+    {
+        SeekSet = 0,
+        SeekCur = 1,
+        SeekEnd = 2
+    };
+
+    class FileImpl;
+    class FSImpl;
+    typedef std::shared_ptr<FileImpl> FileImplPtr;
+    typedef std::shared_ptr<FSImpl> FSImplPtr;
+
+    class File : public Stream
+    {
+    public:
+        File(FileImplPtr p = FileImplPtr()) : _p(p) {}
+
+        size_t write(uint8_t) override { return 0; }
+        size_t write(const uint8_t *, size_t) override { return 0; }
+        int available() override;
+        int read() override;
+        int peek() override;
+        size_t read(uint8_t *buf, size_t size);
+        bool seek(uint32_t pos, SeekMode mode = SeekSet);
+        size_t position() const;
+        size_t size() const;
+        void close();
+        operator bool() const;
+        const char *path() const;
+        const char *name() const;
+        boolean isDirectory(void);
+        File openNextFile(const char *mode = "r");
+        String getNextFileName(void);
+        String getNextFileName(bool *isDir);
+        void rewindDirectory(void);
+
+    private:
+        FileImplPtr _p;
+    };
+
+    class FS
+    {
+    public:
+        FS(FSImplPtr impl) : _impl(impl) {}
+        File open(const char *path, const char *mode = "r", const bool create = false);
+        bool exists(const char *path);
+
+    protected:
+        FSImplPtr _impl;
+    };
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
+
+#endif // EMBEDFS_HOST_FS_H
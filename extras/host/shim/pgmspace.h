@@ -0,0 +1,4 @@
+/*
+  pgmspace.h (host shim): flash is plain memory on the host, so generated headers only
+  need PROGMEM to expand to nothing (the Makefile passes -DPROGMEM=).
+*/
@@ -0,0 +1,215 @@
+/*
+  test_archive.cpp
+
+  The fixture tree as a ustar archive and as a ZIP (text files deflated, the rest stored)
+  mounted in place with beginTar()/beginZip(): contents, listings, hidden gzip twins of
+  deflated entries, peek/seek on inflated files, the ZIP64 end records, and malformed or
+  truncated archives that must not mount (or read outside the buffer under AddressSanitizer).
+*/
+
+#include "check.h"
+
+#include <set>
+#include <vector>
+
+using namespace fs;
+
+static void checkContents(EmbedFSFS &efs)
+{
+    for (size_t i = 0; i < fixturePathCount; ++i)
+    {
+        File f = efs.open(fixturePaths[i]);
+        CHECK(f && f.size() == assetBytes(fixturePaths[i]).size());
+        CHECK(readAll(f) == assetBytes(fixturePaths[i]));
+        EmbedFSHandle h = efs.openHandle(fixturePaths[i]);
+        CHECK(h && readAll(h) == assetBytes(fixturePaths[i]));
+    }
+    File root = efs.open("/");
+    std::set<std::string> names;
+    while (File f = root.openNextFile())
+        names.insert(f.path());
+    std::set<std::string> expected = {"/app.js", "/bin", "/css", "/docs", "/index.html", "/sounds", "/theme", "/tiny"};
+    CHECK(names == expected);
+}
+
+static void checkTar()
+{
+    std::string tar = fixtureFile("assets.tar");
+    CHECK(tar.size() > 512);
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(tar.data());
+    EmbedFSFS efs;
+    CHECK(efs.beginTar(bytes, tar.size()));
+    checkContents(efs);
+    CHECK(strcmp(efs.mimeType("/docs/index.html"), "text/html") == 0);
+
+    // a corrupted header checksum and a truncated entry fail the mount
+    std::string bad = tar;
+    bad[0] ^= 0x20;
+    CHECK(!efs.beginTar(reinterpret_cast<const uint8_t *>(bad.data()), bad.size()));
+    CHECK(!efs.beginTar(bytes, 700));
+    CHECK(!efs.beginTar(bytes, 0));
+    CHECK(efs.exists("/index.html")); // a failed begin keeps the previous mount
+}
+
+// Offset of the central directory record of name, or npos
+static size_t centralRecord(const std::string &zip, const char *name)
+{
+    for (size_t at = zip.find("PK\x01\x02"); at != std::string::npos; at = zip.find("PK\x01\x02", at + 4))
+    {
+        size_t len = static_cast<uint8_t>(zip[at + 28]) | (static_cast<uint8_t>(zip[at + 29]) << 8);
+        if (zip.compare(at + 46, len, name) == 0 && strlen(name) == len)
+            return at;
+    }
+    return std::string::npos;
+}
+
+// Last 8 bytes of a gzip member: CRC-32 and size, little-endian
+static uint32_t trailerSize(const std::string &gz)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(gz.data()) + gz.size() - 4;
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void checkZip()
+{
+    std::string zip = fixtureFile("assets.zip");
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(zip.data());
+    EmbedFSFS efs;
+    CHECK(efs.beginZip(bytes, zip.size()));
+    checkContents(efs);
+
+    // deflated entries have a hidden gzip twin serving the stream as-is
+    File gz = efs.open("/docs/guide.txt.gz");
+    CHECK(gz);
+    std::string member = readAll(gz);
+    CHECK(member.size() > 18 && member.size() < assetBytes("/docs/guide.txt").size());
+    CHECK(static_cast<uint8_t>(member[0]) == 0x1f && static_cast<uint8_t>(member[1]) == 0x8b);
+    CHECK(trailerSize(member) == assetBytes("/docs/guide.txt").size());
+    CHECK(!efs.open("/bin/sparse.bin.gz")); // stored entries have none
+    File docs = efs.open("/docs");
+    size_t listed = 0;
+    while (File f = docs.openNextFile())
+        ++listed;
+    CHECK(listed == 2);
+
+    // peek keeps the inflater position; seeking back restarts it
+    File js = efs.open("/app.js");
+    std::string expected = assetBytes("/app.js");
+    CHECK(js.peek() == expected[0] && js.read() == expected[0]);
+    CHECK(js.seek(100) && js.read() == expected[100]);
+    CHECK(js.seek(10) && js.read() == expected[10]);
+    CHECK(js.seek(0, SeekEnd) && js.read() == -1);
+    EmbedFSHandle h = efs.openHandle("/docs/guide.txt");
+    char line[32];
+    CHECK(h.readUntil('\n', line, sizeof(line)) == 17 && h.peek() == 'l');
+
+    // a stored entry whose uncompressed size exceeds its stored bytes would be read past
+    // them; the archive is rejected
+    std::string bad = zip;
+    size_t record = centralRecord(bad, "sounds/beep.raw");
+    CHECK(record != std::string::npos && bad[record + 10] == 0); // method: stored
+    bad[record + 24 + 2] = 0x10;                                 // uncompressed size += 1 MB
+    CHECK(!efs.beginZip(reinterpret_cast<const uint8_t *>(bad.data()), bad.size()));
+    bad = zip;
+    bad[record + 20] ^= 0x01; // compressed size off by one
+    CHECK(!efs.beginZip(reinterpret_cast<const uint8_t *>(bad.data()), bad.size()));
+
+    // truncated archives have no end of central directory record
+    CHECK(!efs.beginZip(bytes, zip.size() - 30));
+    CHECK(!efs.beginZip(bytes, 10));
+}
+
+// Append v as n little-endian bytes
+static void putLe(std::string &out, uint64_t v, int n)
+{
+    for (int b = 0; b < n; ++b)
+        out.push_back(static_cast<char>(v >> (8 * b)));
+}
+
+static void checkZip64()
+{
+    // the fixture with a ZIP64 end record and locator in front of a saturated classic record
+    std::string zip = fixtureFile("assets.zip");
+    size_t eocd = zip.rfind("PK\x05\x06");
+    CHECK(eocd != std::string::npos && zip.size() == eocd + 22);
+    uint64_t count = static_cast<uint8_t>(zip[eocd + 10]) | (static_cast<uint8_t>(zip[eocd + 11]) << 8);
+    std::string dir = zip.substr(eocd + 12, 8); // central directory size and offset
+    std::string zip64 = zip.substr(0, eocd);
+    putLe(zip64, 0x06064b50, 4);
+    putLe(zip64, 44, 8);
+    putLe(zip64, 45, 2);
+    putLe(zip64, 45, 2);
+    putLe(zip64, 0, 8); // this disk, central directory disk
+    putLe(zip64, count, 8);
+    putLe(zip64, count, 8);
+    for (int field = 0; field < 2; ++field)
+    {
+        uint64_t v = 0;
+        for (int b = 0; b < 4; ++b)
+            v |= static_cast<uint64_t>(static_cast<uint8_t>(dir[field * 4 + b])) << (8 * b);
+        putLe(zip64, v, 8);
+    }
+    putLe(zip64, 0x07064b50, 4);
+    putLe(zip64, 0, 4);
+    putLe(zip64, eocd, 8); // offset of the ZIP64 record
+    putLe(zip64, 1, 4);
+    putLe(zip64, 0x06054b50, 4);
+    putLe(zip64, 0, 4);
+    putLe(zip64, 0xFFFF, 2);
+    putLe(zip64, 0xFFFF, 2);
+    putLe(zip64, 0xFFFFFFFFu, 4);
+    putLe(zip64, 0xFFFFFFFFu, 4);
+    putLe(zip64, 0, 2);
+
+    std::vector<uint8_t> bytes(zip64.begin(), zip64.end());
+    EmbedFSFS efs;
+    CHECK(efs.beginZip(bytes.data(), bytes.size()));
+    checkContents(efs);
+
+    // a locator whose record starts past the end, or too close to it
+    std::string bad;
+    size_t locator = zip64.size() - 22 - 20;
+    const uint64_t pastEnd[] = {zip64.size(), zip64.size() - 55, ~static_cast<uint64_t>(0)};
+    for (uint64_t at : pastEnd)
+    {
+        bad = zip64;
+        for (int b = 0; b < 8; ++b)
+            bad[locator + 8 + b] = static_cast<char>(at >> (8 * b));
+        std::vector<uint8_t> exact(bad.begin(), bad.end());
+        CHECK(!efs.beginZip(exact.data(), exact.size()));
+    }
+
+    // archives of 42 to 55 bytes: a locator and an end record after a ZIP64 record signature
+    // (when there is room), too short for the record the signature starts
+    std::string tail = zip64.substr(locator);
+    CHECK(tail.size() == 42);
+    for (size_t pad = 0; pad < 14; ++pad)
+    {
+        const uint64_t records[] = {0, pad, pad + 20};
+        for (uint64_t at : records)
+        {
+            std::string small = std::string(pad, '\0') + tail;
+            if (pad >= 4)
+                small.replace(0, 4, "PK\x06\x06");
+            for (int b = 0; b < 8; ++b)
+                small[pad + 8 + b] = static_cast<char>(at >> (8 * b));
+            std::vector<uint8_t> exact(small.begin(), small.end());
+            CHECK(!efs.beginZip(exact.data(), exact.size()));
+        }
+    }
+
+    // every truncation of the archive fails cleanly
+    for (size_t size = 0; size < zip64.size(); size += (size < 128 ? 1 : 97))
+    {
+        std::vector<uint8_t> exact(zip64.begin(), zip64.begin() + size);
+        CHECK(!efs.beginZip(exact.data(), exact.size()));
+    }
+}
+
+int main()
+{
+    checkTar();
+    checkZip();
+    checkZip64();
+    return checkDone("test_archive");
+}
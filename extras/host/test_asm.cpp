@@ -0,0 +1,41 @@
+/*
+  test_asm.cpp
+
+  The --emit asm output of the fixture tree, assembled from the generated .S files (the
+  Makefile passes -I$(BUILD), which the assembler searches for the .incbin payloads) and
+  linked into a PIE that may not carry text relocations: arrays and a packed image mount
+  and read every file and alias.
+*/
+
+#include "check.h"
+#include "fixture_asm_arrays.h"
+#include "fixture_asm_packed.h"
+
+using namespace fs;
+
+static void checkContents(EmbedFSFS &efs)
+{
+    for (size_t i = 0; i < fixturePathCount; ++i)
+    {
+        File file = efs.open(fixturePaths[i]);
+        CHECK(file && readAll(file) == assetBytes(fixturePaths[i]));
+    }
+    File alias = efs.open("/app");
+    CHECK(alias && readAll(alias) == assetBytes("/index.html"));
+    alias = efs.open("/tiny/c.txt");
+    CHECK(alias && readAll(alias) == "bb");
+    EmbedFSHandle handle = efs.openHandle("/sounds/beep.raw");
+    CHECK(readAll(handle) == assetBytes("/sounds/beep.raw"));
+}
+
+int main()
+{
+    EmbedFSFS efs;
+    CHECK(efs.begin(asa_file_names, asa_file_data, asa_file_sizes, asa_file_count, asa_file_listed_count));
+    CHECK(efs.core()->listedCount() == asa_file_listed_count);
+    checkContents(efs);
+
+    CHECK(efs.begin(asp_image));
+    checkContents(efs);
+    return checkDone("test_asm");
+}
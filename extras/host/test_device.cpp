@@ -0,0 +1,141 @@
+/*
+  test_device.cpp
+
+  The fixture tree as a device image (--emit image, inline entries up to 32 bytes, a skip
+  slot every 4 entries) mounted through EmbedFSFileDevice and from RAM through
+  EmbedFSCallbackDevice: contents and block cache reads, then damaged headers, TOCs and
+  skip tables, which must either fail the mount or stay inside the image.
+*/
+
+#include "check.h"
+
+#include <set>
+
+using namespace fs;
+
+static const size_t headerBytes = EMBEDFS_DEVICE_HEADER_WORDS * 4;
+
+// Little-endian word at byte offset at
+static uint32_t word(const std::string &image, size_t at)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(image.data()) + at;
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void setWord(std::string &image, size_t at, uint32_t v)
+{
+    for (int b = 0; b < 4; ++b)
+        image[at + b] = static_cast<char>(v >> (8 * b));
+}
+
+static bool readRam(void *context, uint32_t offset, uint8_t *buf, size_t size)
+{
+    const std::string *image = static_cast<const std::string *>(context);
+    if (offset > image->size() || size > image->size() - offset)
+        return false;
+    memcpy(buf, image->data() + offset, size);
+    return true;
+}
+
+static void checkContents(EmbedFSFS &efs)
+{
+    for (size_t i = 0; i < fixturePathCount; ++i)
+    {
+        File f = efs.open(fixturePaths[i]);
+        CHECK(f && readAll(f) == assetBytes(fixturePaths[i]));
+        EmbedFSHandle h = efs.openHandle(fixturePaths[i]);
+        CHECK(h && readAll(h) == assetBytes(fixturePaths[i]));
+    }
+    File app = efs.open("/app");
+    CHECK(app && readAll(app) == assetBytes("/index.html"));
+    CHECK(strcmp(efs.mimeType("/app"), "text/html") == 0);
+}
+
+// Mount image from RAM; when it mounts, every file must read back without leaving it
+static bool mountAndRead(const std::string &image)
+{
+    EmbedFSCallbackDevice device(readRam, const_cast<std::string *>(&image));
+    EmbedFSFS efs;
+    if (!efs.begin(device, 64, 2))
+        return false;
+    for (size_t i = 0; i < efs.core()->fileCount(); ++i)
+    {
+        EmbedFSReader reader;
+        efs.core()->open(i, reader);
+        readAll(reader);
+    }
+    efs.totalBytes();
+    efs.footprint();
+    return true;
+}
+
+int main()
+{
+    EmbedFSFileDevice file(FIXTURE_DIR "/fixture.img");
+    CHECK(file.isOpen());
+    EmbedFSFS efs;
+    CHECK(efs.begin(file, 128, 4));
+    checkContents(efs);
+    checkFootprint(efs, "footprint_device.json", false); // names are copied to RAM
+    CHECK(efs.footprint().cache > 0 && efs.footprint().mount > 0);
+    File root = efs.open("/");
+    std::set<std::string> names;
+    while (File f = root.openNextFile())
+        names.insert(f.path());
+    CHECK(names.size() == 8 && names.count("/tiny") && !names.count("/app"));
+    efs.end();
+
+    std::string image = fixtureFile("fixture.img");
+    CHECK(mountAndRead(image));
+    uint32_t namesSize = word(image, 5 * 4), tocSize = word(image, 6 * 4), skipWords = word(image, 7 * 4);
+    size_t toc = headerBytes + namesSize;
+    size_t skip = toc + tocSize;
+    CHECK(skipWords == 8);
+
+    // header fields that disagree with the TOC
+    std::string bad = image;
+    setWord(bad, 6 * 4, tocSize - 1);
+    CHECK(!mountAndRead(bad));
+    bad = image;
+    setWord(bad, 11 * 4, word(image, 11 * 4) - 1); // blob one byte short
+    CHECK(!mountAndRead(bad));
+    bad = image;
+    setWord(bad, 2 * 4, word(image, 2 * 4) + 1); // one entry more than the names
+    CHECK(!mountAndRead(bad));
+
+    // MIME ids of another type table are ignored: the extensionless alias loses its type
+    {
+        CHECK(word(image, 9 * 4) == EmbedFSMime::tableHash());
+        bad = image;
+        setWord(bad, 9 * 4, EmbedFSMime::tableHash() + 1);
+        EmbedFSCallbackDevice device(readRam, &bad);
+        EmbedFSFS stale;
+        CHECK(stale.begin(device));
+        CHECK(strcmp(stale.mimeType("/app"), "application/octet-stream") == 0);
+        CHECK(strcmp(stale.mimeType("/css/site.css"), "text/css") == 0);
+        CHECK(efs.begin(file) && strcmp(efs.mimeType("/app"), "text/html") == 0);
+    }
+
+    // skip table slots must point at their entries
+    for (size_t w = 0; w < skipWords; ++w)
+    {
+        bad = image;
+        setWord(bad, skip + w * 4, word(image, skip + w * 4) + 1);
+        CHECK(!mountAndRead(bad));
+    }
+
+    // every single-bit error in the TOC either fails the mount or reads inside the image
+    size_t mounted = 0;
+    for (size_t at = toc; at < skip; ++at)
+    {
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            bad = image;
+            bad[at] ^= static_cast<char>(1 << bit);
+            mounted += mountAndRead(bad);
+        }
+    }
+    CHECK(mounted < tocSize * 8);
+    printf("TOC bit flips: %zu of %zu mounted\n", mounted, static_cast<size_t>(tocSize) * 8);
+    return checkDone("test_device");
+}
@@ -0,0 +1,304 @@
+/*
+  test_formats.cpp
+
+  The fixture tree mounted as generated arrays, as a packed image (aliases, inline and
+  sparse entries, MIME ids, preload list, content hashes, tags) and as a packed image with
+  front-coded names, through the FS adapter: contents, listings, default documents, index
+  modes and the persisted index, openHandle(), openByHash(), openTagged() and openSearch().
+*/
+
+#include "check.h"
+#include "fixture_arrays.h"
+#include "fixture_names.h"
+#include "fixture_packed.h"
+
+#include <chrono>
+#include <set>
+#include <vector>
+#include <thread>
+
+using namespace fs;
+
+static void checkContents(EmbedFSFS &efs)
+{
+    for (size_t i = 0; i < fixturePathCount; ++i)
+    {
+        File f = efs.open(fixturePaths[i]);
+        CHECK(f);
+        CHECK(!f.isDirectory());
+        std::string expected = assetBytes(fixturePaths[i]);
+        CHECK(f.size() == expected.size());
+        CHECK(readAll(f) == expected);
+        CHECK(efs.exists(fixturePaths[i]));
+    }
+    // aliases read their target's bytes
+    File app = efs.open("/app");
+    CHECK(app && readAll(app) == assetBytes("/index.html"));
+    File c = efs.open("tiny/c.txt");
+    CHECK(c && readAll(c) == "bb");
+    CHECK(!efs.open("/missing.txt"));
+    CHECK(!efs.exists("/tiny/d.txt"));
+
+    // seek inside and past the end
+    File sparse = efs.open("/bin/sparse.bin");
+    CHECK(sparse.seek(4000));
+    CHECK(sparse.read() == 1);
+    CHECK(sparse.seek(8188) && readAll(sparse) == "TAIL");
+    CHECK(!sparse.seek(9000, SeekSet));
+}
+
+static void checkListing(EmbedFSFS &efs)
+{
+    File root = efs.open("/");
+    CHECK(root && root.isDirectory());
+    std::set<std::string> names;
+    while (File f = root.openNextFile())
+        names.insert(f.path());
+    // hidden aliases are not listed
+    std::set<std::string> expected = {"/app.js", "/bin", "/css", "/docs", "/index.html", "/sounds", "/theme", "/tiny"};
+    CHECK(names == expected);
+    File tiny = efs.open("/tiny");
+    size_t files = 0;
+    while (File f = tiny.openNextFile())
+        ++files;
+    CHECK(files == 2);
+
+    const char *const documents[] = {"index.htm", "index.html"};
+    efs.setDefaultDocuments(documents, 2);
+    File docs = efs.open("/docs");
+    CHECK(docs && !docs.isDirectory() && strcmp(docs.path(), "/docs/index.html") == 0);
+    EmbedFSHandle handle = efs.openHandle("/docs/");
+    CHECK(handle && strcmp(handle.path(), "/docs/index.html") == 0);
+    efs.setDefaultDocuments(nullptr, 0);
+    CHECK(efs.open("/docs").isDirectory());
+}
+
+static void checkHandle(EmbedFSFS &efs)
+{
+    EmbedFSHandle h = efs.openHandle("/docs/guide.txt");
+    CHECK(h && h.size() == assetBytes("/docs/guide.txt").size());
+    char line[64];
+    size_t lines = 0;
+    while (h.available())
+    {
+        size_t n = h.readUntil('\n', line, sizeof(line));
+        CHECK(n == 17 && memcmp(line, "line of the guide", n) == 0);
+        ++lines;
+    }
+    CHECK(lines == 20);
+    CHECK(h.read() == -1 && h.peek() == -1);
+
+    // a handle converts to a File at the same position
+    EmbedFSHandle s = efs.openHandle("/bin/sparse.bin");
+    CHECK(s.peek() == 'H' && s.read() == 'H');
+    File f = s;
+    CHECK(f && f.position() == 1 && f.read() == 'E');
+    CHECK(!efs.openHandle("/nope"));
+}
+
+static void checkIndexModes(EmbedFSFS &efs, bool (*mount)(EmbedFSFS &))
+{
+    const IndexMode modes[] = {IndexOff, IndexEager, IndexLazy, IndexBackground};
+    for (IndexMode mode : modes)
+    {
+        efs.setIndex(mode);
+        CHECK(mount(efs));
+        for (size_t i = 0; i < fixturePathCount; ++i)
+            CHECK(efs.exists(fixturePaths[i]));
+        CHECK(efs.exists("app") && !efs.exists("/ap"));
+        for (int wait = 0; mode == IndexBackground && !efs.indexReady() && wait < 1000; ++wait)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (mode == IndexOff)
+            CHECK(!efs.indexReady() || efs.core()->hasNameDictionary());
+        CHECK(efs.open("/css/site.css"));
+    }
+
+    // persisted index: adopted by the next begin() whatever the mode
+    efs.setIndex(IndexEager);
+    CHECK(mount(efs));
+    StringPrint blob;
+    size_t written = efs.writeIndex(blob);
+    efs.setIndex(IndexOff);
+    if (efs.core()->hasNameDictionary())
+    {
+        CHECK(written == 0); // front-coded names are searched in place
+        efs.setIndex(IndexOff);
+        return;
+    }
+    CHECK(written == blob.out.size() && written > 0);
+    efs.end();
+    efs.setIndexCache(reinterpret_cast<const uint8_t *>(blob.out.data()), blob.out.size());
+    CHECK(mount(efs));
+    CHECK(efs.indexReady());
+    for (size_t i = 0; i < fixturePathCount; ++i)
+        CHECK(efs.exists(fixturePaths[i]));
+    // a damaged blob falls back to the configured mode
+    std::string bad = blob.out;
+    bad[bad.size() - 1] ^= 0x55;
+    bad[20] ^= 0x55;
+    efs.end();
+    efs.setIndexCache(reinterpret_cast<const uint8_t *>(bad.data()), bad.size());
+    CHECK(mount(efs));
+    CHECK(!efs.indexReady());
+    CHECK(efs.exists("/tiny/a.txt"));
+}
+
+static void checkPacked(EmbedFSFS &efs, const EmbedFSImage &image)
+{
+    // MIME ids keep the target's type on the extensionless alias
+    CHECK(strcmp(efs.mimeType("/app"), "text/html") == 0);
+    CHECK(strcmp(efs.mimeType("/css/site.css"), "text/css") == 0);
+    CHECK(strcmp(efs.mimeType("/not/mounted.json"), "application/json") == 0);
+    // ids from another MIME table are ignored in favour of the extension
+    EmbedFSImage stale = image;
+    stale.mimeTable ^= 1;
+    EmbedFSFS other;
+    CHECK(other.begin(stale));
+    CHECK(strcmp(other.mimeType("/app"), "application/octet-stream") == 0);
+    CHECK(strcmp(other.mimeType("/css/site.css"), "text/css") == 0);
+
+    // the image's preload list is used unless setPreload() was called
+    CHECK(efs.preloadedBytes() > 0);
+    File css = efs.open("/css/site.css");
+    CHECK(css && readAll(css) == assetBytes("/css/site.css"));
+    const char *const none[] = {"/nothing/*"};
+    efs.setPreload(none, 1);
+    CHECK(efs.preloadedBytes() == 0);
+    const char *const all[] = {"*"};
+    efs.setPreload(all, 1);
+    CHECK(efs.preloadedBytes() >= assetBytes("/bin/sparse.bin").size());
+    checkContents(efs);
+    efs.setPreload(image.preload, image.preloadCount);
+
+    // tags
+    File sounds = efs.openTagged("sounds");
+    CHECK(sounds && sounds.isDirectory() && strcmp(sounds.path(), "sounds") == 0);
+    std::set<std::string> paths;
+    while (File f = sounds.openNextFile())
+    {
+        paths.insert(f.path());
+        CHECK(readAll(f) == assetBytes(f.path()));
+    }
+    CHECK(paths == std::set<std::string>({"/sounds/beep.raw", "/sounds/click.raw"}));
+    const char *const webTiny[] = {"web", "tiny"};
+    File none2 = efs.openTagged(webTiny, 2);
+    CHECK(none2 && !none2.openNextFile());
+    const char *const tinyTiny[] = {"tiny", "tiny"};
+    File tiny = efs.openTagged(tinyTiny, 2);
+    size_t count = 0;
+    while (File f = tiny.openNextFile())
+        ++count;
+    CHECK(count == 3); // a.txt, b.txt and the alias c.txt
+    CHECK(!efs.openTagged("nope"));
+    CHECK(efs.core()->tagCount() == 3 && strcmp(efs.core()->tagName(0), "sounds") == 0);
+}
+
+static void checkSearch(EmbedFSFS &efs, bool (*mount)(EmbedFSFS &))
+{
+    const char *const roots[] = {"/theme/dark", "/theme/base/", "/"};
+    efs.setSearchPaths(roots, 3, 8);
+    size_t root = 0;
+    File logo = efs.openSearch("logo.svg", &root);
+    CHECK(logo && root == 0 && readAll(logo) == assetBytes("/theme/dark/logo.svg"));
+    File font = efs.openSearch("/font.txt", &root);
+    CHECK(font && root == 1 && strcmp(font.path(), "/theme/base/font.txt") == 0);
+    File app = efs.openSearch("app", &root); // cached and uncached lookups agree
+    CHECK(app && root == 2);
+    app = efs.openSearch("app", &root);
+    CHECK(app && root == 2);
+    CHECK(!efs.openSearch("nothing.txt", &root) && root == EmbedFSCore::npos);
+    // configured before begin()
+    CHECK(mount(efs));
+    CHECK(efs.openSearch("logo.svg", &root) && root == 0);
+    efs.setSearchPaths(nullptr, 0);
+    CHECK(!efs.openSearch("logo.svg"));
+}
+
+// The generator's name digest keys a saved index like the names themselves: an index
+// written from the same names mounted as arrays (hashed at runtime) is adopted by the image
+static void checkNameDigest(const EmbedFSImage &image)
+{
+    CHECK(image.nameDigest != 0);
+    std::vector<const uint8_t *> data(image.fileCount, reinterpret_cast<const uint8_t *>(""));
+    std::vector<size_t> sizes(image.fileCount, 0);
+    EmbedFSFS efs;
+    efs.setIndex(IndexEager);
+    CHECK(efs.begin(image.fileNames, data.data(), sizes.data(), image.fileCount));
+    CHECK(efs.core()->nameDigest() == 0);
+    StringPrint blob;
+    CHECK(efs.writeIndex(blob) > 0);
+    efs.end();
+    efs.setIndex(IndexOff);
+    efs.setIndexCache(reinterpret_cast<const uint8_t *>(blob.out.data()), blob.out.size());
+    CHECK(efs.begin(image) && efs.indexReady() && efs.core()->nameDigest() == image.nameDigest);
+    for (size_t i = 0; i < fixturePathCount; ++i)
+        CHECK(efs.exists(fixturePaths[i]));
+    // another digest means other names: the blob is ignored
+    EmbedFSImage other = image;
+    other.nameDigest ^= 1;
+    efs.end();
+    efs.setIndexCache(reinterpret_cast<const uint8_t *>(blob.out.data()), blob.out.size());
+    CHECK(efs.begin(other) && !efs.indexReady());
+}
+
+static bool mountArrays(EmbedFSFS &efs)
+{
+    return efs.begin(arr_file_names, arr_file_data, arr_file_sizes, arr_file_count, arr_file_listed_count);
+}
+static bool mountPacked(EmbedFSFS &efs) { return efs.begin(pk_image); }
+static bool mountNames(EmbedFSFS &efs) { return efs.begin(fc_image); }
+
+int main()
+{
+    EmbedFSFS efs;
+    CHECK(!efs.open("/index.html"));
+
+    bool (*const mounts[])(EmbedFSFS &) = {mountArrays, mountPacked, mountNames};
+    const char *const reports[] = {"footprint_arrays.json", "footprint_packed.json", "footprint_names.json"};
+    for (size_t m = 0; m < 3; ++m)
+    {
+        auto mount = mounts[m];
+        CHECK(mount(efs));
+        checkFootprint(efs, reports[m], true);
+        if (mount == mountArrays) // every file once, aliases share their target's array
+        {
+            size_t bytes = 0;
+            for (size_t i = 0; i < fixturePathCount; ++i)
+                bytes += assetBytes(fixturePaths[i]).size();
+            CHECK(efs.footprint().fileData == bytes);
+        }
+        checkContents(efs);
+        checkListing(efs);
+        checkHandle(efs);
+        checkSearch(efs, mount);
+        checkIndexModes(efs, mount);
+        CHECK(efs.totalBytes() == efs.usedBytes() && efs.totalBytes() > 8192);
+    }
+
+    CHECK(mountPacked(efs));
+    checkPacked(efs, pk_image);
+    // content hash: every entry by its first 8 hex digits, ambiguous or short prefixes fail
+    for (size_t i = 0; i < pk_image.contentHashCount; ++i)
+    {
+        char hex[17];
+        snprintf(hex, sizeof(hex), "%08x%08x", static_cast<unsigned>(pk_content_hash[i * 3]),
+                 static_cast<unsigned>(pk_content_hash[i * 3 + 1]));
+        hex[8] = '\0';
+        EmbedFSHandle h = efs.openByHash(hex);
+        CHECK(h && strcmp(h.path(), pk_file_names[pk_content_hash[i * 3 + 2]]) == 0);
+        CHECK(readAll(h) == assetBytes(h.path()));
+    }
+    CHECK(!efs.openByHash("zz") && !efs.openByHash(""));
+    checkNameDigest(pk_image);
+    CHECK(fc_image.nameDigest == 0); // front-coded names are never indexed
+
+    CHECK(mountNames(efs));
+    CHECK(efs.core()->hasNameDictionary() && !efs.core()->fileNames());
+    checkPacked(efs, fc_image);
+    for (size_t i = 0; i < efs.core()->fileCount(); ++i)
+        CHECK(efs.core()->find(efs.core()->fileName(i)) == i);
+
+    efs.end();
+    CHECK(!efs.exists("/index.html") && efs.totalBytes() == 0);
+    return checkDone("test_formats");
+}
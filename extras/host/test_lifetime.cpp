@@ -0,0 +1,89 @@
+/*
+  test_lifetime.cpp
+
+  Files, handles and directories kept open while the filesystem is unmounted, remounted or
+  its preload set changes: reads still return the file's bytes (run under AddressSanitizer,
+  which reports any read of freed memory) and directories end their listing. Covers preloaded
+  files of a packed image and inline and blob entries of a device image.
+*/
+
+#include "check.h"
+#include "fixture_packed.h"
+
+using namespace fs;
+
+// Preloaded files keep their RAM copy alive
+static void checkPreload()
+{
+    EmbedFSFS efs;
+    CHECK(efs.begin(pk_image));
+    CHECK(efs.preloadedBytes() > 0); // /css/site.css and /tiny/a.txt from the image's list
+    File css = efs.open("/css/site.css");
+    EmbedFSHandle tiny = efs.openHandle("/tiny/a.txt");
+    uint8_t head[4];
+    CHECK(css.read(head, sizeof(head)) == sizeof(head));
+
+    // a new preload set frees the old block once no reader holds it
+    const char *const other[] = {"/docs/*"};
+    efs.setPreload(other, 1);
+    File docs = efs.open("/docs/guide.txt");
+    efs.end();
+    CHECK(readAll(css) == assetBytes("/css/site.css").substr(sizeof(head)));
+    CHECK(readAll(tiny) == "A");
+    CHECK(readAll(docs) == assetBytes("/docs/guide.txt"));
+
+    // copies made after end() still read, and so does a File across a remount
+    CHECK(efs.begin(pk_image));
+    File kept = efs.open("/docs/index.html");
+    EmbedFSHandle copy = efs.openHandle("/docs/guide.txt");
+    CHECK(efs.begin(pk_image));
+    efs.end();
+    CHECK(readAll(kept) == assetBytes("/docs/index.html"));
+    File converted = copy;
+    CHECK(readAll(converted) == assetBytes("/docs/guide.txt"));
+}
+
+// Inline device entries keep the RAM index alive, blob entries the block cache
+static void checkDevice()
+{
+    EmbedFSFileDevice file(FIXTURE_DIR "/fixture.img");
+    EmbedFSFS efs;
+    CHECK(efs.begin(file));
+    File inlined = efs.open("/tiny/b.txt"); // under --inline-max 32
+    EmbedFSHandle alias = efs.openHandle("/tiny/c.txt");
+    File blob = efs.open("/docs/guide.txt");
+    CHECK(efs.begin(file));
+    efs.end();
+    CHECK(readAll(inlined) == "bb");
+    CHECK(readAll(alias) == "bb");
+    CHECK(readAll(blob) == assetBytes("/docs/guide.txt"));
+}
+
+// Directories and tag views stop listing once their mount is gone
+static void checkDirectories()
+{
+    EmbedFSFS efs;
+    CHECK(efs.begin(pk_image));
+    File root = efs.open("/");
+    File sounds = efs.openTagged("sounds");
+    File first = root.openNextFile();
+    CHECK(first);
+    efs.end();
+    CHECK(!root.openNextFile());
+    CHECK(root.getNextFileName().length() == 0);
+    CHECK(!sounds.openNextFile());
+    CHECK(readAll(first).size() == first.size());
+
+    CHECK(efs.begin(pk_image));
+    File tiny = efs.open("/tiny");
+    CHECK(efs.begin(pk_image)); // remount: the old listing's mount is gone
+    CHECK(!tiny.openNextFile());
+}
+
+int main()
+{
+    checkPreload();
+    checkDevice();
+    checkDirectories();
+    return checkDone("test_lifetime");
+}
@@ -0,0 +1,68 @@
+/*
+  test_profile.cpp
+
+  Access profile of the packed fixture: startProfile()/stopProfile() bracket the counted
+  opens, writeProfile() lists each file once in first-access order with its open count, and
+  max_entries caps the distinct files kept. The last profile is written to
+  FIXTURE_DIR/profile.txt, which test_profile.py feeds back into tools/embed_assets.py.
+*/
+
+#include "check.h"
+#include "fixture_packed.h"
+
+using namespace fs;
+
+static std::string profileOf(const EmbedFSFS &efs, size_t lines)
+{
+    StringPrint out;
+    CHECK(efs.writeProfile(out) == lines);
+    return out.out;
+}
+
+static void openAll(EmbedFSFS &efs, const char *const paths[], size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        File f = efs.open(paths[i]);
+        CHECK(f);
+    }
+}
+
+int main()
+{
+    EmbedFSFS efs;
+    CHECK(!efs.startProfile());
+    CHECK(efs.begin(pk_image));
+    CHECK(!efs.startProfile(0));
+
+    // nothing is counted before startProfile(), after stopProfile(), or by lookups without an open
+    efs.open("/index.html");
+    CHECK(efs.startProfile());
+    const char *const opens[] = {"/sounds/beep.raw", "/docs/guide.txt", "/tiny/a.txt", "/docs/guide.txt",
+                                 "/index.html",      "/docs/guide.txt", "/index.html", "/tiny/a.txt",
+                                 "/docs/guide.txt",  "/index.html"};
+    openAll(efs, opens, sizeof(opens) / sizeof(opens[0]));
+    CHECK(efs.exists("/app.js") && !efs.open("/missing.txt"));
+    EmbedFSHandle handle = efs.openHandle("/sounds/beep.raw");
+    CHECK(handle);
+    efs.stopProfile();
+    efs.open("/docs/guide.txt");
+    const std::string profile = profileOf(efs, 4);
+    CHECK(profile == "2 /sounds/beep.raw\r\n4 /docs/guide.txt\r\n2 /tiny/a.txt\r\n3 /index.html\r\n");
+
+    // a restart clears the profile; files past max_entries are dropped, kept ones still count
+    CHECK(efs.startProfile(2));
+    CHECK(profileOf(efs, 0).empty());
+    const char *const capped[] = {"/app.js", "/css/site.css", "/docs/index.html", "/app.js", "/sounds/click.raw"};
+    openAll(efs, capped, sizeof(capped) / sizeof(capped[0]));
+    CHECK(profileOf(efs, 2) == "2 /app.js\r\n1 /css/site.css\r\n");
+
+    efs.end();
+    CHECK(profileOf(efs, 0).empty());
+
+    FILE *f = fopen(FIXTURE_DIR "/profile.txt", "wb");
+    CHECK(f && fwrite(profile.data(), 1, profile.size(), f) == profile.size());
+    if (f)
+        fclose(f);
+    return checkDone("test_profile");
+}
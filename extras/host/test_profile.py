@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Feed the profile test_profile wrote back into tools/embed_assets.py --profile: entries
+come out most opened first, profiled data first in first-access order, and profiled files
+that fit a --profile-line do not straddle one.
+Usage: test_profile.py BUILD_DIR
+"""
+
+from __future__ import annotations
+
+import json
+import pathlib
+import subprocess
+import sys
+
+GENERATOR = pathlib.Path(__file__).resolve().parent.parent.parent / "tools" / "embed_assets.py"
+LINE = 32
+
+FAILURES = 0
+
+
+def check(condition: bool, what: str) -> None:
+    global FAILURES
+    if not condition:
+        FAILURES += 1
+        print(f"FAIL: {what}")
+
+
+def main() -> int:
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    build = pathlib.Path(sys.argv[1])
+    profile = build / "profile.txt"
+    lines = profile.read_text(encoding="utf-8").splitlines()
+    first_access = [line.split(" ", 1)[1] for line in lines]
+    counts = {line.split(" ", 1)[1]: int(line.split(" ", 1)[0]) for line in lines}
+    report = build / "footprint_profiled.json"
+    command = [sys.executable, str(GENERATOR), str(build / "assets"), "-o", str(build / "profiled.h"), "--no-cache",
+               "-j", "1", "--format", "packed", "--inline-max", "0", "--profile", str(profile),
+               "--profile-line", str(LINE), "--report", str(report)]
+    subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+    entries = json.loads(report.read_text(encoding="utf-8"))["entries"]
+
+    paths = [entry["path"] for entry in entries]
+    by_count = sorted(first_access, key=lambda path: -counts[path])
+    check(paths[: len(by_count)] == by_count, f"entry order {paths[:len(by_count)]} != {by_count}")
+    check(sorted(paths) == sorted(set(paths)), "every entry once")
+
+    placed = {entry["path"]: entry for entry in entries if entry["placement"] == "blob"}
+    hot = sorted((placed[path]["offset"], path) for path in first_access)
+    check([path for _, path in hot] == first_access, f"data order {hot} != {first_access}")
+    hot_end = max(offset + placed[path]["stored"] for offset, path in hot)
+    cold = [entry["offset"] for path, entry in placed.items() if path not in counts]
+    check(all(offset >= hot_end for offset in cold), "cold data after the profiled data")
+    for offset, path in hot:
+        size = placed[path]["stored"]
+        if size <= LINE:
+            check(offset // LINE == (offset + size - 1) // LINE, f"{path} at {offset} straddles a line")
+
+    print("test_profile.py: " + ("ok" if FAILURES == 0 else f"{FAILURES} failed"))
+    return 1 if FAILURES else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
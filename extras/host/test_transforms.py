@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""Built-in minifiers of tools/asset_transforms.py on inputs whose string literals contain
+the punctuation and whitespace the minifiers squeeze: literals must come out unchanged.
+Then tools/embed_assets.py with transforms on one worker and on several: every output
+(header, asm, device image, report) must be byte-identical.
+Usage: test_transforms.py
+"""
+
+from __future__ import annotations
+
+import json
+import pathlib
+import subprocess
+import sys
+import tempfile
+
+TOOLS = pathlib.Path(__file__).resolve().parent.parent.parent / "tools"
+sys.path.insert(0, str(TOOLS))
+import asset_transforms  # noqa: E402
+
+FAILURES = 0
+
+
+def check(condition: bool, what: str) -> None:
+    global FAILURES
+    if not condition:
+        FAILURES += 1
+        print(f"FAIL: {what}")
+
+
+def minify(step: str, text: str) -> str:
+    result, _ = asset_transforms.apply_rule({"match": "*", "steps": [step]}, text.encode("utf-8"), "test", None)
+    return result.decode("utf-8")
+
+
+def check_css() -> None:
+    css = minify("minify-css", '  a , b {\n  color : red ;\n}  /* note */\np { margin: 0; }\n')
+    check(css == "a,b{color : red}p{margin: 0}", f"css whitespace: {css!r}")
+    # punctuation and spaces inside quotes are content
+    css = minify("minify-css", 'a[href*="x ; y"] { content: "{ ; }" ; }\nq::before { content: \'a , b;}\' }')
+    check(css == 'a[href*="x ; y"]{content: "{ ; }"}q::before{content: \'a , b;}\'}', f"css strings: {css!r}")
+    css = minify("minify-css", 'p { content: "say \\"; }\\"" ; }')
+    check(css == 'p{content: "say \\"; }\\""}', f"css escaped quote: {css!r}")
+    check(minify("minify-css", '/* only */  ') == "", "css comment only")
+
+
+def check_others() -> None:
+    html = minify("minify-html", "<p>a  <!-- x -->\n  b</p>\n<pre>  keep ; }  </pre>\n")
+    check(html == "<p>a\nb</p>\n<pre>  keep ; }  </pre>", f"html: {html!r}")
+    check(minify("minify-json", '{ "a": "x , y",\n "b": [1, 2] }') == '{"a":"x , y","b":[1,2]}', "json")
+    check(minify("minify-svg", "<svg>\n  <!-- c -->\n  <g/>\n</svg>") == "<svg><g/></svg>", "svg")
+
+
+def write_tree(root: pathlib.Path) -> None:
+    """60 files, enough for every worker to get several of each kind."""
+    for i in range(12):
+        files = {
+            f"page{i}.html": f"<p>page {i}  <!-- c -->\n  text</p>\n" * (i + 1),
+            f"css/s{i}.css": f"p{i} {{ color : red ; }}  /* c */\n" * (i + 1),
+            f"js/a{i}.js": f"var a{i} = {i};\n" * (i + 1),
+            f"img/i{i}.svg": f"<svg>\n  <!-- c -->\n  <g id='{i}'/>\n</svg>" * (i + 1),
+            f"data/d{i}.json": json.dumps({"i": i, "v": list(range(i))}, indent=2),
+        }
+        for path, text in files.items():
+            (root / path).parent.mkdir(parents=True, exist_ok=True)
+            (root / path).write_text(text, encoding="utf-8")
+
+
+def check_jobs() -> None:
+    """Outputs of -j 1 and -j 4 with transforms (gzip included) must match byte for byte."""
+    manifest = {
+        "transforms": [
+            {"match": "*.html", "steps": ["minify-html", "gzip"]},
+            {"match": "*.css", "steps": ["minify-css", "gzip"]},
+            {"match": "*.svg", "steps": ["minify-svg"]},
+            {"match": "*.json", "steps": ["minify-json"]},
+        ]
+    }
+    with tempfile.TemporaryDirectory() as tmp:
+        root = pathlib.Path(tmp)
+        write_tree(root / "assets")
+        (root / "manifest.json").write_text(json.dumps(manifest), encoding="utf-8")
+        runs = [
+            ("assets_embed.h", ["--format", "packed", "--content-hash", "--emit", "asm"]),
+            ("assets_arrays.h", []),
+            ("assets.img", ["--format", "packed", "--emit", "image"]),
+        ]
+        for jobs in ("1", "4"):
+            out = root / f"j{jobs}"
+            out.mkdir()
+            for name, options in runs:
+                command = [sys.executable, str(TOOLS / "embed_assets.py"), str(root / "assets"), "-o", str(out / name),
+                           "--no-cache", "-j", jobs, "--manifest", str(root / "manifest.json"),
+                           "--report", str(out / (name + ".json")), *options]
+                subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+        one = sorted(p.name for p in (root / "j1").iterdir())
+        check(one == sorted(p.name for p in (root / "j4").iterdir()), f"same outputs: {one}")
+        check(len(one) == 8, f"every output written: {one}")
+        for name in one:
+            check((root / "j1" / name).read_bytes() == (root / "j4" / name).read_bytes(), f"-j 1 vs -j 4: {name}")
+
+
+def main() -> int:
+    check_css()
+    check_others()
+    check_jobs()
+    print("test_transforms: " + ("ok" if FAILURES == 0 else f"{FAILURES} failed"))
+    return 1 if FAILURES else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,17 +1,16 @@
 /*
   EmbedFS.cpp
-  Clean implementation for EmbedFS.h without EmbedFSFile helper.
+  FS adapter over EmbedFSCore: FileImpl/FSImpl wrappers and the EmbedFSFS API.
 */
 
 #include "EmbedFS.h"
+#include "EmbedFSInflate.h"
+#include "EmbedFSMime.h"
 #include "FSImpl.h"
 
-#if defined(__AVR__)
-#include <pgmspace.h>
-#endif
-
 #include <cstring>
 #include <cstdlib>
+#include <memory>
 #include <string>
 #include <vector>
 #include <utility>
@@ -20,12 +19,37 @@ using namespace fs;
 
 class EmbedFSImpl;
 
-// Embedded-backed FileImpl: provides read-only access to embedded arrays
+// Where file and directory objects are allocated (EmbedFSPolicy.h)
+typedef EmbedFSDefaultPolicy::Handles Handles;
+
+// "/" + name without its leading and trailing '/'
+static std::string displayPath(const char *name)
+{
+    if (*name == '/')
+        ++name;
+    size_t len = strlen(name);
+    while (len && name[len - 1] == '/')
+        --len;
+    return std::string("/").append(name, len);
+}
+
+// Live File and directory objects of every EmbedFSFS, for footprint()
+static EmbedFSCounter liveFiles(0);
+static EmbedFSCounter liveFileBytes(0);
+static EmbedFSCounter liveDirs(0);
+static EmbedFSCounter liveDirBytes(0);
+
+// Print sink for EmbedFSCore::writeIndex()/writeProfile()/writeFootprint()
+static size_t printWrite(void *context, const uint8_t *data, size_t size)
+{
+    return static_cast<Print *>(context)->write(data, size);
+}
+
+// Embedded-backed FileImpl: read-only access through an EmbedFSReader
 class EmbeddedFileImpl : public FileImpl
 {
 public:
-    EmbeddedFileImpl(const char *path, const uint8_t *data, size_t size)
-        : _path(nullptr), _name(nullptr), _data(data), _size(size), _pos(0)
+    explicit EmbeddedFileImpl(const char *path) : _path(nullptr), _name(nullptr)
     {
         if (path)
             _path = strdup(path);
@@ -38,56 +62,46 @@ public:
         {
             _name = strdup(_path);
         }
+        _bytes = sizeof(*this) + (_path ? strlen(_path) + 1 : 0) + (_name ? strlen(_name) + 1 : 0);
+        ++liveFiles;
+        liveFileBytes += _bytes;
     }
 
-    virtual ~EmbeddedFileImpl()
+    EmbeddedFileImpl(const char *path, const EmbedFSReader &reader) : EmbeddedFileImpl(path) { _reader = reader; }
+
+    ~EmbeddedFileImpl() override
     {
+        --liveFiles;
+        liveFileBytes -= _bytes;
         if (_path)
             free((void *)_path);
         if (_name)
             free((void *)_name);
     }
 
+    EmbedFSReader &reader() { return _reader; }
+
     // write is unsupported for read-only embedded FS
     size_t write(const uint8_t * /*buf*/, size_t /*size*/) override { return 0; }
 
-    size_t read(uint8_t *buf, size_t size) override
-    {
-        if (!_data || _pos >= _size)
-            return 0;
-        size_t remaining = _size - _pos;
-        size_t toRead = (size < remaining) ? size : remaining;
-        for (size_t i = 0; i < toRead; ++i)
-        {
-#if defined(__AVR__)
-            buf[i] = pgm_read_byte(_data + _pos + i);
-#else
-            buf[i] = _data[_pos + i];
-#endif
-        }
-        _pos += toRead;
-        return toRead;
-    }
+    size_t read(uint8_t *buf, size_t size) override { return _reader.read(buf, size); }
 
     void flush() override {}
 
     bool seek(uint32_t pos, SeekMode mode) override
     {
-        size_t newpos = _pos;
+        size_t newpos = _reader.position();
         if (mode == SeekSet)
             newpos = pos;
         else if (mode == SeekCur)
-            newpos = _pos + pos;
+            newpos = _reader.position() + pos;
         else if (mode == SeekEnd)
-            newpos = _size + pos;
-        if (newpos > _size)
-            return false;
-        _pos = newpos;
-        return true;
+            newpos = _reader.size() + pos;
+        return _reader.seek(newpos);
     }
 
-    size_t position() const override { return _pos; }
-    size_t size() const override { return _size; }
+    size_t position() const override { return _reader.position(); }
+    size_t size() const override { return _reader.size(); }
 
     bool setBufferSize(size_t) override { return false; }
 
@@ -106,44 +120,36 @@ public:
     String getNextFileName(bool * /*isDir*/) override { return String(); }
     void rewindDirectory(void) override {}
 
-    operator bool() override { return _data != nullptr; }
+    operator bool() override { return _reader.isOpen(); }
 
 private:
     char *_path;
     char *_name;
-    const uint8_t *_data;
-    size_t _size;
-    size_t _pos;
+    size_t _bytes; // counted in liveFileBytes
+    EmbedFSReader _reader;
 };
 
-// Directory view for embedded FS
+// Directory view for embedded FS: the children of a directory, or the files of a tag
+// (EmbedFSFS::openTagged()) opened by entry number
 class EmbeddedDirImpl : public FileImpl
 {
 public:
-    struct Entry
+    EmbeddedDirImpl(const char *path, std::weak_ptr<EmbedFSImpl> owner, std::vector<EmbedFSCore::DirEntry> &&entries)
+        : _path(nullptr), _name(nullptr), _owner(owner), _entries(std::move(entries)), _tag(false), _index(0)
     {
-        std::string path; // absolute path starting with '/'
-        bool isDir;
-    };
+        init(path);
+    }
 
-    EmbeddedDirImpl(const char *path, EmbedFSImpl *owner, std::vector<Entry> &&entries)
-        : _path(nullptr), _name(nullptr), _owner(owner), _entries(std::move(entries)), _index(0)
+    EmbeddedDirImpl(const char *path, std::weak_ptr<EmbedFSImpl> owner, std::vector<uint32_t> &&tagged)
+        : _path(nullptr), _name(nullptr), _owner(owner), _tagged(std::move(tagged)), _tag(true), _index(0)
     {
-        if (path)
-            _path = strdup(path);
-        const char *p = _path ? strrchr(_path, '/') : nullptr;
-        if (p && *(p + 1))
-        {
-            _name = strdup(p + 1);
-        }
-        else if (_path)
-        {
-            _name = strdup(_path);
-        }
+        init(path);
     }
 
     ~EmbeddedDirImpl() override
     {
+        --liveDirs;
+        liveDirBytes -= _bytes;
         if (_path)
             free((void *)_path);
         if (_name)
@@ -172,157 +178,111 @@ public:
     operator bool() override { return _path != nullptr; }
 
 private:
+    void init(const char *path)
+    {
+        if (path)
+            _path = strdup(path);
+        const char *p = _path ? strrchr(_path, '/') : nullptr;
+        if (p && *(p + 1))
+        {
+            _name = strdup(p + 1);
+        }
+        else if (_path)
+        {
+            _name = strdup(_path);
+        }
+        _bytes = sizeof(*this) + (_path ? strlen(_path) + 1 : 0) + (_name ? strlen(_name) + 1 : 0) +
+                 EmbedFSCore::listingBytes(_entries) + _tagged.capacity() * sizeof(uint32_t);
+        ++liveDirs;
+        liveDirBytes += _bytes;
+    }
+
+    size_t count() const { return _tag ? _tagged.size() : _entries.size(); }
+    std::string nextPath(EmbedFSImpl &owner);
+
     char *_path;
     char *_name;
-    EmbedFSImpl *_owner;
-    std::vector<Entry> _entries;
+    std::weak_ptr<EmbedFSImpl> _owner; // expires at end() or the next begin()
+    std::vector<EmbedFSCore::DirEntry> _entries;
+    std::vector<uint32_t> _tagged; // entry numbers of a tag view
+    bool _tag;
     size_t _index;
+    size_t _bytes; // counted in liveDirBytes
 };
 
-// FSImpl that serves embedded arrays
-class EmbedFSImpl : public FSImpl
+// FSImpl over the mounted EmbedFSCore
+class EmbedFSImpl : public FSImpl, public std::enable_shared_from_this<EmbedFSImpl>
 {
 public:
-    EmbedFSImpl(const char *const file_names[], const uint8_t *const file_data[], const size_t file_sizes[], size_t file_count)
-        : names_(file_names), data_(file_data), sizes_(file_sizes), count_(file_count) {}
-    virtual ~EmbedFSImpl() {}
+    EmbedFSCore &core() { return core_; }
 
     FileImplPtr open(const char *path, const char * /*mode*/, const bool /*create*/) override
     {
         if (!path)
             return FileImplPtr();
-        // normalize path (accept with or without leading '/')
-        std::string p(path);
-        if (!p.empty() && p.front() == '/')
-            p.erase(0, 1);
-        while (!p.empty() && p.back() == '/')
-            p.pop_back();
-        std::string display = p.empty() ? std::string("/") : (std::string("/") + p);
-
-        for (size_t i = 0; i < count_; ++i)
+        std::string display;
+        size_t i = core_.find(path);
+        if (i != EmbedFSCore::npos)
         {
-            if (!names_[i])
-                continue;
-            std::string nj(names_[i]);
-            if (!nj.empty() && nj.front() == '/')
-                nj.erase(0, 1);
-            while (!nj.empty() && nj.back() == '/')
-                nj.pop_back();
-            if (nj == p)
-                return std::make_shared<EmbeddedFileImpl>(display.c_str(), data_[i], sizes_[i]);
+            display = displayPath(path);
         }
-        // treat as directory if any entry has this prefix
-        std::vector<EmbeddedDirImpl::Entry> entries;
-        auto addUnique = [&entries](const std::string &path, bool isDir) {
-            for (auto &entry : entries)
-            {
-                if (entry.path == path)
-                {
-                    if (isDir && !entry.isDir)
-                        entry.isDir = true;
-                    return;
-                }
-            }
-            entries.push_back({path, isDir});
-        };
-
-        std::string prefix = p.empty() ? std::string() : (p + '/');
-        for (size_t i = 0; i < count_; ++i)
+        else
         {
-            if (!names_[i])
-                continue;
-            std::string fn(names_[i]);
-            if (!fn.empty() && fn.front() == '/')
-                fn.erase(0, 1);
-            while (!fn.empty() && fn.back() == '/')
-                fn.pop_back();
-            if (p.empty())
-            {
-                if (fn.empty())
-                    continue;
-                size_t slashPos = fn.find('/');
-                bool isDir = (slashPos != std::string::npos);
-                std::string childName = isDir ? fn.substr(0, slashPos) : fn;
-                std::string childPath = std::string("/") + childName;
-                addUnique(childPath, isDir);
-            }
-            else
-            {
-                if (fn.size() <= prefix.size() || fn.compare(0, prefix.size(), prefix) != 0)
-                    continue;
-                std::string remainder = fn.substr(prefix.size());
-                if (remainder.empty())
-                    continue;
-                size_t slashPos = remainder.find('/');
-                bool isDir = (slashPos != std::string::npos);
-                std::string childName = isDir ? remainder.substr(0, slashPos) : remainder;
-                std::string childPath = std::string("/") + p + "/" + childName;
-                addUnique(childPath, isDir);
-            }
+            i = core_.findDefaultDocument(path);
+            if (i != EmbedFSCore::npos)
+                display = displayPath(core_.fileName(i));
         }
-        if (!entries.empty() || p.empty())
-            return std::make_shared<EmbeddedDirImpl>(display.c_str(), this, std::move(entries));
+        if (i != EmbedFSCore::npos)
+            return openEntry(i, display.c_str());
+        // treat as directory if any entry has this prefix
+        std::vector<EmbedFSCore::DirEntry> entries;
+        if (core_.list(path, entries))
+            return Handles::make<EmbeddedDirImpl>(displayPath(path).c_str(), shared_from_this(), std::move(entries));
         return FileImplPtr();
     }
 
-    bool exists(const char *path) override
+    // File of entry i, shown as display
+    FileImplPtr openEntry(size_t i, const char *display)
     {
-        if (!path)
-            return false;
-        std::string p(path);
-        if (!p.empty() && p.front() == '/')
-            p.erase(0, 1);
-        while (!p.empty() && p.back() == '/')
-            p.pop_back();
-        if (p.empty())
-            return true;
-        for (size_t i = 0; i < count_; ++i)
-        {
-            if (!names_[i])
-                continue;
-            std::string nj(names_[i]);
-            if (!nj.empty() && nj.front() == '/')
-                nj.erase(0, 1);
-            while (!nj.empty() && nj.back() == '/')
-                nj.pop_back();
-            if (nj == p)
-                return true;
-        }
-        std::string prefix = p.empty() ? std::string() : (p + '/');
-        for (size_t i = 0; i < count_; ++i)
-        {
-            if (!names_[i])
-                continue;
-            std::string fn(names_[i]);
-            if (!fn.empty() && fn.front() == '/')
-                fn.erase(0, 1);
-            while (!fn.empty() && fn.back() == '/')
-                fn.pop_back();
-            if (prefix.empty() || (fn.size() > prefix.size() && fn.compare(0, prefix.size(), prefix) == 0))
-                return true;
-        }
-        return false;
+        std::shared_ptr<EmbeddedFileImpl> file = Handles::make<EmbeddedFileImpl>(display);
+        if (file)
+            core_.open(i, file->reader());
+        return file;
     }
 
+    bool exists(const char *path) override { return core_.exists(path); }
+
     bool rename(const char * /*pathFrom*/, const char * /*pathTo*/) override { return false; }
     bool remove(const char * /*path*/) override { return false; }
     bool mkdir(const char * /*path*/) override { return false; }
     bool rmdir(const char * /*path*/) override { return false; }
 
 private:
-    const char *const *names_;
-    const uint8_t *const *data_;
-    const size_t *sizes_;
-    size_t count_;
+    EmbedFSCore core_;
 };
 
 FileImplPtr EmbeddedDirImpl::openNextFile(const char *mode)
 {
-    if (_index >= _entries.size() || !_owner)
+    std::shared_ptr<EmbedFSImpl> owner = _owner.lock();
+    if (_index >= count() || !owner)
         return FileImplPtr();
     size_t current = _index++;
+    if (_tag)
+    {
+        uint32_t entry = _tagged[current];
+        return owner->openEntry(entry, displayPath(owner->core().fileName(entry)).c_str());
+    }
     const char *openMode = (mode && *mode) ? mode : "r";
-    return _owner->open(_entries[current].path.c_str(), openMode, false);
+    return owner->open(_entries[current].path.c_str(), openMode, false);
+}
+
+// Path of the child at _index, advancing past it; the mount is still alive
+std::string EmbeddedDirImpl::nextPath(EmbedFSImpl &owner)
+{
+    size_t current = _index++;
+    if (_tag)
+        return displayPath(owner.core().fileName(_tagged[current]));
+    return _entries[current].path;
 }
 
 boolean EmbeddedDirImpl::seekDir(long position)
@@ -330,57 +290,207 @@ boolean EmbeddedDirImpl::seekDir(long position)
     if (position < 0)
         return false;
     size_t pos = static_cast<size_t>(position);
-    if (pos > _entries.size())
-        pos = _entries.size();
+    if (pos > count())
+        pos = count();
     _index = pos;
     return true;
 }
 
 String EmbeddedDirImpl::getNextFileName(void)
 {
-    if (_index >= _entries.size())
+    std::shared_ptr<EmbedFSImpl> owner = _owner.lock();
+    if (_index >= count() || !owner)
         return String();
-    size_t current = _index++;
-    return String(_entries[current].path.c_str());
+    return String(nextPath(*owner).c_str());
 }
 
 String EmbeddedDirImpl::getNextFileName(bool *isDir)
 {
-    if (_index >= _entries.size())
+    std::shared_ptr<EmbedFSImpl> owner = _owner.lock();
+    if (_index >= count() || !owner)
         return String();
-    size_t current = _index++;
     if (isDir)
-        *isDir = _entries[current].isDir;
-    return String(_entries[current].path.c_str());
+        *isDir = !_tag && _entries[_index].isDir;
+    return String(nextPath(*owner).c_str());
 }
 
 // ---------------- EmbedFSFS (public API) ----------------
-EmbedFSFS::EmbedFSFS() : FS(FSImplPtr(nullptr)), fileNames_(nullptr), fileData_(nullptr), fileSizes_(nullptr), fileCount_(0) {}
+// Engine of a mounted impl, or nullptr
+static EmbedFSCore *coreOf(const FSImplPtr &impl) { return impl ? &static_cast<EmbedFSImpl *>(impl.get())->core() : nullptr; }
+
+EmbedFSFS::EmbedFSFS()
+    : FS(FSImplPtr(nullptr)), defaultDocuments_(nullptr), defaultDocumentCount_(0), searchPaths_(nullptr), searchPathCount_(0),
+      searchCacheSlots_(0), preloadPatterns_(nullptr), preloadCount_(0), preloadMemory_(PreloadAny), preloadConfigured_(false),
+      indexMode_(IndexOff), indexCache_(nullptr), indexCacheSize_(0) {}
 EmbedFSFS::~EmbedFSFS() { end(); }
 
-bool EmbedFSFS::begin(const char *const file_names[], const uint8_t *const file_data[], const size_t file_sizes[], size_t file_count)
+template <typename MountCore>
+bool EmbedFSFS::mount(MountCore mountCore, const EmbedFSImage *image)
 {
-    if (!file_names || !file_data || !file_sizes || file_count == 0)
+    std::unique_ptr<EmbedFSImpl> impl(new EmbedFSImpl());
+    EmbedFSCore &core = impl->core();
+    if (!mountCore(core))
         return false;
-    _impl = FSImplPtr(new EmbedFSImpl(file_names, file_data, file_sizes, file_count));
-    fileNames_ = file_names;
-    fileData_ = file_data;
-    fileSizes_ = file_sizes;
-    fileCount_ = file_count;
+    core.setIndex(indexMode_, indexCache_, indexCacheSize_);
+    indexCache_ = nullptr; // used by one begin() only
+    core.setDefaultDocuments(defaultDocuments_, defaultDocumentCount_);
+    core.setSearchPaths(searchPaths_, searchPathCount_, searchCacheSlots_);
+    if (image && !preloadConfigured_)
+        core.setPreload(image->preload, image->preloadCount, preloadMemory_);
+    else
+        core.setPreload(preloadPatterns_, preloadCount_, preloadMemory_);
+    _impl = FSImplPtr(impl.release());
     return true;
 }
 
+bool EmbedFSFS::begin(const char *const file_names[], const uint8_t *const file_data[], const size_t file_sizes[], size_t file_count,
+                      size_t listed_count)
+{
+    return mount([&](EmbedFSCore &core) { return core.begin(file_names, file_data, file_sizes, file_count, listed_count); });
+}
+
+bool EmbedFSFS::begin(const EmbedFSImage &image)
+{
+    return mount([&](EmbedFSCore &core) { return core.begin(image); }, &image);
+}
+
+bool EmbedFSFS::begin(EmbedFSBlockDevice &device, size_t block_size, size_t cache_blocks)
+{
+    return mount([&](EmbedFSCore &core) { return core.begin(device, block_size, cache_blocks); });
+}
+
+bool EmbedFSFS::beginTar(const uint8_t *archive, size_t size)
+{
+    return mount([&](EmbedFSCore &core) { return core.beginTar(archive, size); });
+}
+
+bool EmbedFSFS::beginZip(const uint8_t *archive, size_t size)
+{
+    return mount([&](EmbedFSCore &core) { return core.beginZip(archive, size); });
+}
+
 bool EmbedFSFS::begin(bool /*formatOnFail*/, const char * /*basePath*/, uint8_t /*maxOpenFiles*/, const char * /*partitionLabel*/) { return (_impl != nullptr); }
 bool EmbedFSFS::format() { return false; }
-void EmbedFSFS::end()
+void EmbedFSFS::end() { _impl.reset(); }
+
+EmbedFSCore *EmbedFSFS::core() const { return coreOf(_impl); }
+
+void EmbedFSFS::setDefaultDocuments(const char *const documents[], size_t count)
 {
-    _impl.reset();
-    fileNames_ = nullptr;
-    fileData_ = nullptr;
-    fileSizes_ = nullptr;
-    fileCount_ = 0;
+    defaultDocuments_ = count ? documents : nullptr;
+    defaultDocumentCount_ = documents ? count : 0;
+    if (_impl)
+        coreOf(_impl)->setDefaultDocuments(defaultDocuments_, defaultDocumentCount_);
 }
 
+void EmbedFSFS::setSearchPaths(const char *const roots[], size_t count, size_t cache_slots)
+{
+    searchPaths_ = count ? roots : nullptr;
+    searchPathCount_ = roots ? count : 0;
+    searchCacheSlots_ = cache_slots;
+    if (_impl)
+        coreOf(_impl)->setSearchPaths(searchPaths_, searchPathCount_, searchCacheSlots_);
+}
+
+void EmbedFSFS::setPreload(const char *const patterns[], size_t count, PreloadMemory memory)
+{
+    preloadPatterns_ = count ? patterns : nullptr;
+    preloadCount_ = patterns ? count : 0;
+    preloadMemory_ = memory;
+    preloadConfigured_ = true;
+    if (_impl)
+        coreOf(_impl)->setPreload(preloadPatterns_, preloadCount_, preloadMemory_);
+}
+
+void EmbedFSFS::setIndex(IndexMode mode)
+{
+    indexMode_ = mode;
+    if (_impl)
+        coreOf(_impl)->setIndex(mode);
+}
+
+void EmbedFSFS::setIndexCache(const uint8_t *blob, size_t size)
+{
+    indexCache_ = size ? blob : nullptr;
+    indexCacheSize_ = blob ? size : 0;
+    if (_impl && indexCache_)
+    {
+        coreOf(_impl)->setIndex(indexMode_, indexCache_, indexCacheSize_);
+        indexCache_ = nullptr;
+    }
+}
+
+size_t EmbedFSFS::writeIndex(Print &out) const
+{
+    if (!_impl)
+        return 0;
+    return coreOf(_impl)->writeIndex(printWrite, &out);
+}
+
+bool EmbedFSFS::indexReady() const
+{
+    if (!_impl)
+        return false;
+    return coreOf(_impl)->indexReady();
+}
+
+size_t EmbedFSFS::preloadedBytes() const
+{
+    if (!_impl)
+        return 0;
+    return coreOf(_impl)->preloadedBytes();
+}
+
+const char *EmbedFSFS::mimeType(const char *path) const
+{
+    if (!_impl)
+        return EmbedFSMime::typeFromPath(path);
+    return EmbedFSMime::type(coreOf(_impl)->mimeId(path));
+}
+
+bool EmbedFSFS::startProfile(size_t max_entries)
+{
+    if (!_impl || max_entries == 0)
+        return false;
+    coreOf(_impl)->startProfile(max_entries);
+    return true;
+}
+
+void EmbedFSFS::stopProfile()
+{
+    if (_impl)
+        coreOf(_impl)->stopProfile();
+}
+
+size_t EmbedFSFS::writeProfile(Print &out) const
+{
+    if (!_impl)
+        return 0;
+    return coreOf(_impl)->writeProfile(printWrite, &out);
+}
+
+EmbedFSFootprint EmbedFSFS::footprint() const
+{
+    EmbedFSFootprint fp = {};
+    if (_impl)
+    {
+        fp = coreOf(_impl)->footprint();
+        fp.engine += sizeof(EmbedFSImpl) - sizeof(EmbedFSCore);
+    }
+    else
+    {
+        fp.inflate = EmbedFSInflate::liveBytes();
+    }
+    fp.files = liveFileBytes;
+    fp.openFiles = liveFiles;
+    fp.dirs = liveDirBytes;
+    fp.openDirs = liveDirs;
+    fp.slots = Handles::idleBytes<EmbeddedFileImpl>() + Handles::idleBytes<EmbeddedDirImpl>();
+    return fp;
+}
+
+size_t EmbedFSFS::writeFootprint(Print &out) const { return EmbedFSCore::writeFootprint(footprint(), printWrite, &out); }
+
 bool EmbedFSFS::exists(const char *path) const
 {
     if (!_impl)
@@ -394,14 +504,79 @@ File EmbedFSFS::open(const char *path, const char *mode) const
     return File(_impl->open(path, mode, false));
 }
 
+EmbedFSHandle EmbedFSFS::openHandle(const char *path) const
+{
+    EmbedFSHandle handle;
+    EmbedFSCore *core = coreOf(_impl);
+    if (!core || !path)
+        return handle;
+    size_t i = core->find(path);
+    if (i != EmbedFSCore::npos)
+    {
+        handle.path_ = displayPath(path);
+    }
+    else
+    {
+        i = core->findDefaultDocument(path);
+        if (i != EmbedFSCore::npos)
+            handle.path_ = displayPath(core->fileName(i));
+    }
+    if (i != EmbedFSCore::npos)
+        core->open(i, handle);
+    return handle;
+}
+
+EmbedFSHandle EmbedFSFS::openByHash(const char *hex) const
+{
+    EmbedFSHandle handle;
+    EmbedFSCore *core = coreOf(_impl);
+    size_t i = core ? core->findByHash(hex) : EmbedFSCore::npos;
+    if (i == EmbedFSCore::npos)
+        return handle;
+    handle.path_ = displayPath(core->fileName(i));
+    core->open(i, handle);
+    return handle;
+}
+
+File EmbedFSFS::openSearch(const char *name, size_t *root) const
+{
+    EmbedFSCore *core = coreOf(_impl);
+    size_t i = core ? core->findInSearchPaths(name, root) : EmbedFSCore::npos;
+    if (i == EmbedFSCore::npos)
+    {
+        if (root)
+            *root = EmbedFSCore::npos;
+        return File();
+    }
+    return File(static_cast<EmbedFSImpl *>(_impl.get())->openEntry(i, displayPath(core->fileName(i)).c_str()));
+}
+
+File EmbedFSFS::openTagged(const char *tag) const { return openTagged(&tag, 1); }
+
+File EmbedFSFS::openTagged(const char *const tags[], size_t count) const
+{
+    EmbedFSCore *core = coreOf(_impl);
+    std::vector<uint32_t> entries;
+    if (!core || !core->tagged(tags, count, entries))
+        return File();
+    std::string path(tags[0]);
+    for (size_t t = 1; t < count; ++t)
+        path.append(1, '+').append(tags[t]);
+    return File(Handles::make<EmbeddedDirImpl>(path.c_str(), std::static_pointer_cast<EmbedFSImpl>(_impl), std::move(entries)));
+}
+
+EmbedFSHandle::operator File() const
+{
+    if (!isOpen())
+        return File();
+    return File(Handles::make<EmbeddedFileImpl>(path(), *this));
+}
+
 size_t EmbedFSFS::totalBytes()
 {
-    if (!fileSizes_)
+    if (!_impl)
         return 0;
-    size_t sum = 0;
-    for (size_t i = 0; i < fileCount_; ++i)
-        sum += fileSizes_[i];
-    return sum;
+    return coreOf(_impl)->totalBytes();
 }
 size_t EmbedFSFS::usedBytes() { return totalBytes(); }
 
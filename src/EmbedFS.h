@@ -1,11 +1,12 @@
 /*
   EmbedFS.h
 
-  Minimal EmbedFS implementation for Arduino/ESP32 projects.
-  - Provides EmbedFSClass with begin(...) accepting generated arrays from assets_embed.h
-  - Provides EmbedFSFile for reading embedded data without copying into RAM when possible
-
-  This file is intentionally small and portable. Implementation is in EmbedFS.cpp.
+  Read-only filesystem for Arduino/ESP32 projects over assets embedded at build time.
+  - EmbedFSFS (global instance EmbedFS) is an fs::FS: begin() mounts generated arrays, a
+    packed image, a device image, or a tar/ZIP archive, and open() returns ordinary Files
+  - EmbedFSHandle is a non-virtual reader for hot loops that converts to File when needed
+  - EmbedFSFS::core() exposes the Arduino-independent engine (EmbedFSCore.h) behind the
+    mount; EmbedFS.cpp adapts the FS API to it
 */
 
 #ifndef EMBEDFS_H
@@ -14,23 +15,71 @@
 #include <Arduino.h>
 // Use FS.h to keep LittleFS-like API
 #include "FS.h"
+#include "EmbedFSCore.h"
+#include "EmbedFSMime.h"
 #include <stddef.h>
 
 namespace fs
 {
 
-    // (Removed) Lightweight embedded-file reader type was removed from the public API.
+    // EmbedFS-native file handle for hot loops, from EmbedFSFS::openHandle(). A final,
+    // non-virtual EmbedFSReader: no vtable, and reads touch no refcount, so read(), peek(),
+    // available(), seek() and readUntil() compile to pointer arithmetic on memory-mapped
+    // images. Converts to File (same file and position, independent afterwards) where an
+    // API needs one. Keeps reading after end() or a remount while the image stays readable:
+    // RAM copies it reads from (preloaded files, a device image's index) stay allocated.
+    class EmbedFSHandle final : public EmbedFSReader
+    {
+    public:
+        const char *path() const { return path_.c_str(); }
+        explicit operator bool() const { return isOpen(); }
+        operator File() const;
+
+    private:
+        friend class EmbedFSFS;
+        std::string path_;
+    };
 
     // EmbedFSFS: LittleFS-like class in fs namespace. Read-only filesystem backed by
     // embedded arrays (assets_file_names, assets_file_data, assets_file_sizes, assets_file_count).
+    // PreloadMemory and IndexMode are declared in EmbedFSCore.h.
+    // Files come from the build's handle policy (EmbedFSPolicy.h). On AVR at most
+    // EMBEDFS_AVR_HANDLES files (default 2) and as many directories are open at once; further
+    // opens return an invalid File until a File and all its copies are closed.
     class EmbedFSFS : public FS
     {
     public:
         EmbedFSFS();
         ~EmbedFSFS();
 
-        // Initialize from generated arrays (example in examples/EmbedFSTest)
-        bool begin(const char *const file_names[], const uint8_t *const file_data[], const size_t file_sizes[], size_t file_count);
+        // Initialize from generated arrays (example in examples/EmbedFSTest).
+        // listed_count: only the first listed_count entries appear in directory listings
+        // (hidden aliases are emitted after them); 0 lists every entry.
+        bool begin(const char *const file_names[], const uint8_t *const file_data[], const size_t file_sizes[], size_t file_count,
+                   size_t listed_count = 0);
+
+        // Initialize from a packed image (tools/embed_assets.py --format packed)
+        bool begin(const EmbedFSImage &image);
+
+        // Mount a device image (tools/embed_assets.py --emit image) from external storage.
+        // The index (names, TOC, skip table, MIME ids) is loaded into RAM; file data is read
+        // through a cache of cache_blocks blocks of block_size bytes. The TOC and skip table
+        // are checked against the header while loading, so a damaged image fails here instead
+        // of reading outside itself later. device must outlive every open File. Not
+        // available on AVR.
+        bool begin(EmbedFSBlockDevice &device, size_t block_size = 512, size_t cache_blocks = 8);
+
+        // Mount a ustar archive in place (see EmbedFSArchive.h), e.g. a .tar embedded with
+        // board_build.embed_files or mapped from a data partition. Headers are parsed once
+        // into a RAM index; reads are zero-copy from archive, which must stay valid while
+        // mounted. False when the archive is malformed or holds no files. Not available on AVR.
+        bool beginTar(const uint8_t *archive, size_t size);
+
+        // Mount a ZIP archive in place from its central directory. Stored files are read
+        // zero-copy; deflated files are inflated while reading (32 KB window per open file,
+        // less for small files) and each also appears as a hidden "path.gz" that serves the
+        // compressed stream as-is for clients accepting gzip. Not available on AVR.
+        bool beginZip(const uint8_t *archive, size_t size);
 
         // LittleFS-like overload for compatibility (no-op for embedded data)
         bool begin(bool formatOnFail = false, const char *basePath = "/embedfs", uint8_t maxOpenFiles = 10, const char *partitionLabel = nullptr);
@@ -48,14 +97,108 @@ namespace fs
         // FS-like helpers
         bool exists(const char *path) const;
         File open(const char *path, const char *mode = "r") const;
-
-        // (removed) Direct embedded file reader: openEmbedded() was removed from the API
+        // Native handle for the file (or directory default document) at path; closed when
+        // there is none
+        EmbedFSHandle openHandle(const char *path) const;
+        // Native handle for the file whose content hash starts with the hex digits at hex,
+        // e.g. the fingerprint of "/static/app.3f9a1c.js" (packed images generated with
+        // --content-hash); closed when none or several files match. Binary search of a table
+        // in the image, no path lookup and no RAM.
+        EmbedFSHandle openByHash(const char *hex) const;
+        // Files carrying tag (packed images generated with manifest "tags"), or every tag in
+        // tags, as a directory File whose openNextFile() opens them in entry order by entry
+        // number; its path is the tags joined with '+'. Invalid when a name is not a tag. The
+        // cost follows the group sizes, not the file count; core()->tagCount()/tagName()
+        // enumerate the tags.
+        File openTagged(const char *tag) const;
+        File openTagged(const char *const tags[], size_t count) const;
+
+        // Resolve directory opens to a default document, e.g. {"index.html", "index.htm"}:
+        // open("/docs") returns /docs/index.html when it exists. The first matching name in
+        // the list wins. The per-directory table is built at begin() (or right away when
+        // already mounted); documents must stay valid while mounted. Pass nullptr to disable.
+        void setDefaultDocuments(const char *const documents[], size_t count);
+
+        // Search paths for openSearch(), e.g. {"/theme/dark", "/theme/base", "/"}: a relative
+        // name resolves to the first root, in order, that holds root/name. A hash table per
+        // root keyed by the names below it is built at begin() (or right away when already
+        // mounted), so a lookup hashes the name once and probes once per root. cache_slots > 0
+        // adds a direct-mapped cache of that many resolutions (rounded up to a power of two).
+        // roots are copied by that begin() and must stay valid until then; pass nullptr to
+        // disable.
+        void setSearchPaths(const char *const roots[], size_t count, size_t cache_slots = 0);
+        // File for name resolved against the search paths, with the position of the matching
+        // root in *root (npos when none matched); invalid when no root holds name
+        File openSearch(const char *name, size_t *root = nullptr) const;
+
+        // Content type for path (see EmbedFSMime). Packed images with per-file MIME ids
+        // answer with one table load, so extensionless aliases keep their target's type;
+        // ids recorded with a different MIME table fall back to the extension.
+        const char *mimeType(const char *path) const;
+
+        // Copy the files matching patterns (paths, '*' and '?' wildcards; '*' also matches
+        // '/') into one RAM block at begin() (or right away when already mounted); open()
+        // and read() then serve them from RAM. Packed images with a generated preload list
+        // use it unless this was called. Patterns must stay valid while mounted; pass
+        // nullptr to disable. Not available on AVR.
+        void setPreload(const char *const patterns[], size_t count, PreloadMemory memory = PreloadAny);
+        // Bytes currently served from RAM (0 when nothing matched or the allocation failed)
+        size_t preloadedBytes() const;
+
+        // Path index used by open()/exists()/mimeType(); applied at begin() (or right away
+        // when already mounted). Its kind comes from the lookup policy of the build
+        // (EmbedFSPolicy.h). indexReady() tells whether lookups use it yet.
+        void setIndex(IndexMode mode);
+        bool indexReady() const;
+
+        // Persisted index: writeIndex() serializes the index (building it first if needed)
+        // into a blob keyed by a hash of the name table, to keep in NVS, LittleFS or a host
+        // file; returns the bytes written, 0 while a background build runs. A blob passed to
+        // setIndexCache() is adopted by begin() (or right away when mounted) with one copy
+        // when the key matches the mounted names, whatever the index mode; otherwise the
+        // index is built per setIndex(). The blob is copied by that one begin() and must stay
+        // valid until then.
+        size_t writeIndex(Print &out) const;
+        void setIndexCache(const uint8_t *blob, size_t size);
+
+        // Access profile for tools/embed_assets.py --profile: while recording, every file
+        // open is counted. Up to max_entries distinct files are kept in first-access order.
+        // startProfile() needs a mounted image and clears the previous profile.
+        bool startProfile(size_t max_entries = 256);
+        void stopProfile();
+        // Write the profile as "<count> <path>" lines; returns the number of lines written.
+        size_t writeProfile(Print &out) const;
+
+        // Flash and RAM taken by EmbedFS: the mounted data by category (file bytes, padding,
+        // names, index structures), RAM of the index, mount, cache, preload and engine, and
+        // every open File and directory of the program. writeFootprint() prints it as
+        // "<key> <bytes>" lines for a diagnostics console; returns the number of lines.
+        EmbedFSFootprint footprint() const;
+        size_t writeFootprint(Print &out) const;
+
+        // Engine behind the current mount (nullptr when unmounted), for lookups and reads
+        // without File/String overhead; valid until the next begin() or end()
+        EmbedFSCore *core() const;
 
     private:
-        const char *const *fileNames_;
-        const uint8_t *const *fileData_;
-        const size_t *fileSizes_;
-        size_t fileCount_;
+        // Shared by the begin() overloads: mountCore(core) mounts a fresh engine, then the
+        // settings made before begin() are applied and it replaces the current mount; image
+        // supplies the preload list unless setPreload() was called
+        template <typename MountCore>
+        bool mount(MountCore mountCore, const EmbedFSImage *image = nullptr);
+
+        const char *const *defaultDocuments_;
+        size_t defaultDocumentCount_;
+        const char *const *searchPaths_;
+        size_t searchPathCount_;
+        size_t searchCacheSlots_;
+        const char *const *preloadPatterns_;
+        size_t preloadCount_;
+        PreloadMemory preloadMemory_;
+        bool preloadConfigured_; // setPreload() overrides an image's preload list
+        IndexMode indexMode_;
+        const uint8_t *indexCache_;
+        size_t indexCacheSize_;
     };
 
 } // namespace fs
@@ -0,0 +1,374 @@
+/*
+  EmbedFSArchive.cpp
+  ustar and ZIP parsing for archives mounted in place.
+*/
+
+#include "EmbedFSArchive.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace fs;
+
+static const size_t TAR_BLOCK = 512;
+static const size_t GZIP_OVERHEAD = 18; // 10-byte header, CRC-32 and size trailer
+
+// Drop leading "./" and '/' and trailing '/'; the result gets one leading '/'
+static std::string archivePath(const std::string &path)
+{
+    size_t begin = 0;
+    while (begin < path.size())
+    {
+        if (path[begin] == '/')
+            ++begin;
+        else if (path.compare(begin, 2, "./") == 0)
+            begin += 2;
+        else
+            break;
+    }
+    size_t end = path.size();
+    while (end > begin && path[end - 1] == '/')
+        --end;
+    return end > begin ? "/" + path.substr(begin, end - begin) : std::string();
+}
+
+// NUL- or length-terminated header field
+static std::string tarField(const uint8_t *field, size_t size)
+{
+    const char *s = reinterpret_cast<const char *>(field);
+    const void *nul = memchr(s, '\0', size);
+    return std::string(s, nul ? static_cast<const char *>(nul) - s : size);
+}
+
+// Octal number field (leading spaces, terminated by NUL or space); false on other bytes
+// or base-256 sizes, which only appear for files too large for this target anyway
+static bool tarOctal(const uint8_t *field, size_t size, uint64_t &value)
+{
+    value = 0;
+    size_t i = 0;
+    while (i < size && field[i] == ' ')
+        ++i;
+    for (; i < size && field[i] != '\0' && field[i] != ' '; ++i)
+    {
+        if (field[i] < '0' || field[i] > '7')
+            return false;
+        value = (value << 3) | static_cast<uint64_t>(field[i] - '0');
+    }
+    return true;
+}
+
+static bool tarChecksumOk(const uint8_t *header)
+{
+    uint64_t stored;
+    if (!tarOctal(header + 148, 8, stored))
+        return false;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < TAR_BLOCK; ++i)
+        sum += (i >= 148 && i < 156) ? ' ' : header[i];
+    return sum == stored;
+}
+
+// Apply the "path" and "linkpath" records of a pax extended header ("<len> key=value\n")
+static void tarPaxRecords(const uint8_t *data, size_t size, std::string &path, std::string &link)
+{
+    const char *p = reinterpret_cast<const char *>(data);
+    const char *end = p + size;
+    while (p < end)
+    {
+        size_t len = 0;
+        const char *q = p;
+        while (q < end && *q >= '0' && *q <= '9')
+            len = len * 10 + static_cast<size_t>(*q++ - '0');
+        if (q >= end || *q != ' ' || len == 0 || len > static_cast<size_t>(end - p))
+            return;
+        const char *record = q + 1;
+        const char *recordEnd = p + len - 1; // the trailing '\n'
+        const char *eq = static_cast<const char *>(memchr(record, '=', recordEnd - record));
+        if (eq)
+        {
+            std::string key(record, eq - record);
+            if (key == "path")
+                path.assign(eq + 1, recordEnd);
+            else if (key == "linkpath")
+                link.assign(eq + 1, recordEnd);
+        }
+        p += len;
+    }
+}
+
+static uint16_t le16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+static uint32_t le32(const uint8_t *p) { return le16(p) | (static_cast<uint32_t>(le16(p + 2)) << 16); }
+static uint64_t le64(const uint8_t *p) { return le32(p) | (static_cast<uint64_t>(le32(p + 4)) << 32); }
+
+// Replace 0xFFFFFFFF sizes/offset of a central directory entry from its ZIP64 extra field,
+// which lists only the saturated values, in this order
+static bool zip64Extra(const uint8_t *extra, size_t size, uint64_t &rawSize, uint64_t &packedSize, uint64_t &offset)
+{
+    for (size_t at = 0; at + 4 <= size;)
+    {
+        uint16_t id = le16(extra + at);
+        size_t len = le16(extra + at + 2);
+        if (at + 4 + len > size)
+            return false;
+        if (id == 0x0001)
+        {
+            const uint8_t *p = extra + at + 4;
+            const uint8_t *end = p + len;
+            uint64_t *fields[] = {&rawSize, &packedSize, &offset};
+            for (uint64_t *field : fields)
+            {
+                if (*field != 0xFFFFFFFFu)
+                    continue;
+                if (end - p < 8)
+                    return false;
+                *field = le64(p);
+                p += 8;
+            }
+            return true;
+        }
+        at += 4 + len;
+    }
+    return true;
+}
+
+bool EmbedFSArchive::parseTar(const uint8_t *archive, size_t size)
+{
+    entries_.clear();
+    size_ = size;
+    std::string longPath, longLink; // from pax or GNU long name entries, for the next entry
+    for (size_t offset = 0; offset + TAR_BLOCK <= size;)
+    {
+        const uint8_t *header = archive + offset;
+        if (header[0] == '\0' && std::all_of(header, header + TAR_BLOCK, [](uint8_t b) { return b == 0; }))
+            break; // end-of-archive marker
+        uint64_t length;
+        if (!tarChecksumOk(header) || !tarOctal(header + 124, 12, length))
+            return false;
+        const uint8_t *data = header + TAR_BLOCK;
+        if (length > size - offset - TAR_BLOCK)
+            return false;
+        char type = static_cast<char>(header[156]);
+        if (type == 'x')
+        {
+            tarPaxRecords(data, length, longPath, longLink);
+        }
+        else if (type == 'L' || type == 'K')
+        {
+            (type == 'L' ? longPath : longLink) = tarField(data, length);
+        }
+        else if (type != 'g')
+        {
+            std::string path = longPath;
+            if (path.empty())
+            {
+                path = tarField(header, 100);
+                std::string prefix = memcmp(header + 257, "ustar", 5) == 0 ? tarField(header + 345, 155) : std::string();
+                if (!prefix.empty())
+                    path = prefix + "/" + path;
+            }
+            if (type == '0' || type == '\0' || type == '7')
+                add(path, std::string(), data, length);
+            else if (type == '1')
+                add(path, longLink.empty() ? tarField(header + 157, 100) : longLink, nullptr, 0);
+            longPath.clear();
+            longLink.clear();
+        }
+        offset += TAR_BLOCK + (length + TAR_BLOCK - 1) / TAR_BLOCK * TAR_BLOCK;
+    }
+    finish();
+    return true;
+}
+
+bool EmbedFSArchive::parseZip(const uint8_t *archive, size_t size)
+{
+    entries_.clear();
+    size_ = size;
+    // End of central directory record: 22 bytes plus a comment of up to 65535 bytes
+    if (!archive || size < 22)
+        return false;
+    size_t eocd = size - 22;
+    size_t stop = size > 22 + 0xFFFF ? size - 22 - 0xFFFF : 0;
+    while (le32(archive + eocd) != 0x06054b50)
+    {
+        if (eocd == stop)
+            return false;
+        --eocd;
+    }
+    uint64_t count = le16(archive + eocd + 10);
+    uint64_t dirSize = le32(archive + eocd + 12);
+    uint64_t dirOffset = le32(archive + eocd + 16);
+    // ZIP64 end of central directory locator right before the record
+    if (eocd >= 20 && le32(archive + eocd - 20) == 0x07064b50)
+    {
+        uint64_t at = le64(archive + eocd - 20 + 8);
+        if (size < 56 || at > size - 56 || le32(archive + at) != 0x06064b50)
+            return false;
+        count = le64(archive + at + 32);
+        dirSize = le64(archive + at + 40);
+        dirOffset = le64(archive + at + 48);
+    }
+    if (dirOffset > size || dirSize > size - dirOffset)
+        return false;
+
+    const uint8_t *p = archive + dirOffset;
+    const uint8_t *end = p + dirSize;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        if (end - p < 46 || le32(p) != 0x02014b50)
+            return false;
+        uint16_t flags = le16(p + 8);
+        uint16_t method = le16(p + 10);
+        uint32_t crc = le32(p + 16);
+        uint64_t packedSize = le32(p + 20);
+        uint64_t rawSize = le32(p + 24);
+        size_t nameLen = le16(p + 28);
+        size_t extraLen = le16(p + 30);
+        size_t commentLen = le16(p + 32);
+        uint32_t attributes = le32(p + 38);
+        uint64_t local = le32(p + 42);
+        size_t record = 46 + nameLen + extraLen + commentLen;
+        if (static_cast<size_t>(end - p) < record ||
+            !zip64Extra(p + 46 + nameLen, extraLen, rawSize, packedSize, local))
+            return false;
+        std::string path(reinterpret_cast<const char *>(p + 46), nameLen);
+        bool unixHost = (p[5] == 3);
+        bool symlink = unixHost && ((attributes >> 16) & 0170000) == 0120000;
+        p += record;
+        if ((flags & 0x0001) || symlink || (!path.empty() && path.back() == '/') || (method != 0 && method != 8))
+            continue;
+        // the local header repeats name and extra field, possibly with other lengths
+        if (size < 30 || local > size - 30 || le32(archive + local) != 0x04034b50)
+            return false;
+        uint64_t data = local + 30 + le16(archive + local + 26) + le16(archive + local + 28);
+        // stored entries are served from the archive bytes, so both sizes must agree
+        if (data > size || packedSize > size - data || rawSize > 0xFFFFFFFFu - GZIP_OVERHEAD ||
+            (method == 0 && rawSize != packedSize))
+            return false;
+        if (method == 0)
+            add(path, std::string(), archive + data, rawSize);
+        else
+            add(path, std::string(), archive + data, rawSize,
+                Coding{Deflate, static_cast<uint32_t>(packedSize), crc, static_cast<uint32_t>(rawSize)});
+    }
+    finish();
+    return true;
+}
+
+void EmbedFSArchive::add(const std::string &path, const std::string &link, const uint8_t *data, size_t size,
+                         const Coding &coding)
+{
+    std::string p = archivePath(path);
+    if (p.empty())
+        return;
+    entries_.push_back(Entry{p, link.empty() ? link : archivePath(link), data, size, coding});
+}
+
+void EmbedFSArchive::finish()
+{
+    // Sort entry positions by path; within a path the last copy replaces the first, which
+    // keeps its position in the listing order
+    std::vector<size_t> order(entries_.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return entries_[a].path < entries_[b].path; });
+    std::vector<bool> dropped(entries_.size(), false);
+    for (size_t i = 0; i < order.size();)
+    {
+        size_t j = i + 1;
+        while (j < order.size() && entries_[order[j]].path == entries_[order[i]].path)
+            dropped[order[j++]] = true;
+        if (j - i > 1)
+        {
+            Entry &first = entries_[order[i]];
+            Entry &last = entries_[order[j - 1]];
+            first.link = last.link;
+            first.data = last.data;
+            first.size = last.size;
+            first.coding = last.coding;
+        }
+        i = j;
+    }
+    order.erase(std::remove_if(order.begin(), order.end(), [&dropped](size_t i) { return dropped[i]; }), order.end());
+
+    // Hard links share their target's bytes; links to missing entries or other links are dropped
+    for (Entry &e : entries_)
+    {
+        if (e.link.empty())
+            continue;
+        auto it = std::lower_bound(order.begin(), order.end(), e.link,
+                                   [this](size_t i, const std::string &path) { return entries_[i].path < path; });
+        if (it != order.end() && entries_[*it].path == e.link && entries_[*it].link.empty())
+        {
+            e.data = entries_[*it].data;
+            e.size = entries_[*it].size;
+        }
+        else
+        {
+            dropped[&e - entries_.data()] = true;
+        }
+    }
+
+    names_.clear();
+    data_.clear();
+    sizes_.clear();
+    codings_.clear();
+    size_t kept = 0;
+    for (size_t i = 0; i < entries_.size(); ++i)
+    {
+        if (dropped[i])
+            continue;
+        if (kept != i)
+            entries_[kept] = std::move(entries_[i]);
+        ++kept;
+    }
+    entries_.resize(kept);
+    listed_ = kept;
+
+    // Hidden "path.gz" twins of deflated entries, unless the archive has that path
+    order.resize(kept);
+    for (size_t i = 0; i < kept; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return entries_[a].path < entries_[b].path; });
+    bool coded = false;
+    for (size_t i = 0; i < listed_; ++i)
+    {
+        if (entries_[i].coding.encoding == Stored)
+            continue;
+        coded = true;
+        std::string twin = entries_[i].path + ".gz";
+        auto it = std::lower_bound(order.begin(), order.end(), twin,
+                                   [this](size_t k, const std::string &path) { return entries_[k].path < path; });
+        if (it != order.end() && entries_[*it].path == twin)
+            continue;
+        Coding gzip = entries_[i].coding;
+        gzip.encoding = Gzip;
+        entries_.push_back(Entry{twin, std::string(), entries_[i].data, gzip.packedSize + GZIP_OVERHEAD, gzip});
+    }
+    entries_.shrink_to_fit();
+    for (const Entry &e : entries_)
+    {
+        names_.push_back(e.path.c_str());
+        data_.push_back(e.data);
+        sizes_.push_back(e.size);
+        if (coded)
+            codings_.push_back(e.coding);
+    }
+}
+
+// Heap bytes of a string; short ones live inside the object (small string optimization)
+static size_t heapBytes(const std::string &s)
+{
+    const char *p = s.data();
+    const char *self = reinterpret_cast<const char *>(&s);
+    return (p >= self && p < self + sizeof(s)) ? 0 : s.capacity() + 1;
+}
+
+size_t EmbedFSArchive::memoryUsage() const
+{
+    size_t bytes = sizeof(*this) + entries_.capacity() * sizeof(Entry);
+    for (const Entry &e : entries_)
+        bytes += heapBytes(e.path) + heapBytes(e.link);
+    bytes += names_.capacity() * sizeof(const char *) + data_.capacity() * sizeof(const uint8_t *);
+    bytes += sizes_.capacity() * sizeof(size_t) + codings_.capacity() * sizeof(Coding);
+    return bytes;
+}
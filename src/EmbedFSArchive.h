@@ -0,0 +1,107 @@
+/*
+  EmbedFSArchive.h
+
+  In-place index of a standard archive, mounted with EmbedFSFS::beginTar() or beginZip().
+  - The archive is parsed once; paths are copied into the index and file data pointers
+    point into the archive bytes, so reads of stored files are zero-copy
+  - The index exposes the same name/data/size arrays as generated assets_embed.h headers,
+    plus the coding of deflated ZIP entries
+
+  The archive must stay in addressable memory (RAM, a memory-mapped partition or an
+  embedded binary) while mounted.
+*/
+
+#ifndef EMBEDFS_ARCHIVE_H
+#define EMBEDFS_ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace fs
+{
+
+    class EmbedFSArchive
+    {
+    public:
+        enum Encoding : uint8_t
+        {
+            Stored,  // data holds the file bytes
+            Deflate, // data holds a raw deflate stream, inflated on read
+            Gzip     // data holds a raw deflate stream, served as a gzip member
+        };
+
+        // How a compressed entry is stored; data points at the raw deflate stream
+        struct Coding
+        {
+            Encoding encoding;
+            uint32_t packedSize; // raw deflate bytes
+            uint32_t crc32;      // of the inflated bytes
+            uint32_t rawSize;    // inflated size
+        };
+
+        // Index a ustar archive: regular files and hard links; POSIX pax "path"/"linkpath"
+        // records and GNU long names are honoured. Directories, symlinks and other entry
+        // types are skipped (directories are implied by file paths). When a path occurs
+        // more than once the last copy wins, as when extracting. False on a bad header
+        // checksum or an entry running past size.
+        bool parseTar(const uint8_t *archive, size_t size);
+
+        // Index a ZIP archive from its central directory (ZIP64 records included). Stored
+        // and deflated entries are served; directories, symlinks, encrypted entries and
+        // other methods are skipped. Each deflated "path" also gets a hidden "path.gz"
+        // twin that serves the same stream as a gzip member without inflating it (unless
+        // the archive has its own "path.gz"). False when the end of central directory
+        // record is missing, an entry lies outside size or a stored entry's sizes differ.
+        bool parseZip(const uint8_t *archive, size_t size);
+
+        const char *const *fileNames() const { return names_.data(); }
+        const uint8_t *const *fileData() const { return data_.data(); }
+        // Served size: inflated size for Deflate, gzip member size for Gzip
+        const size_t *fileSizes() const { return sizes_.data(); }
+        size_t fileCount() const { return names_.size(); }
+        // Entries at or after listedCount() (gzip twins) are left out of listings
+        size_t listedCount() const { return listed_; }
+        // Coding of entry i; nullptr for stored entries
+        const Coding *coding(size_t i) const
+        {
+            return (i < codings_.size() && codings_[i].encoding != Stored) ? &codings_[i] : nullptr;
+        }
+
+        // Bytes of the parsed archive
+        size_t archiveSize() const { return size_; }
+        // RAM held by the index: this object, the entry list with its path strings and the
+        // public arrays
+        size_t memoryUsage() const;
+
+    private:
+        struct Entry
+        {
+            std::string path; // "/dir/file"
+            std::string link; // hard link target (normalized), empty for regular files
+            const uint8_t *data;
+            size_t size;
+            Coding coding;
+        };
+
+        // Queue an entry; path is the archive spelling (leading "./" and '/' are dropped)
+        void add(const std::string &path, const std::string &link, const uint8_t *data, size_t size,
+                 const Coding &coding = Coding{Stored, 0, 0, 0});
+        // Drop overwritten copies, resolve hard links, append gzip twins and build the
+        // public arrays
+        void finish();
+
+        std::vector<Entry> entries_;
+        std::vector<const char *> names_;
+        std::vector<const uint8_t *> data_;
+        std::vector<size_t> sizes_;
+        std::vector<Coding> codings_; // empty when every entry is stored
+        size_t listed_ = 0;
+        size_t size_ = 0;
+    };
+
+} // namespace fs
+
+#endif // EMBEDFS_ARCHIVE_H
@@ -0,0 +1,135 @@
+/*
+  EmbedFSBlockDevice.cpp
+  stdio-backed device and the block cache used by device-mounted packed images.
+*/
+
+#include "EmbedFSBlockDevice.h"
+
+#include <string.h>
+#if defined(ARDUINO)
+#include <Arduino.h>
+#elif !defined(__AVR__)
+#include <chrono>
+
+// Busy-wait like Arduino's delayMicroseconds(), for core-only host builds
+static void delayMicroseconds(uint32_t us)
+{
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < until)
+    {
+    }
+}
+#endif
+
+using namespace fs;
+
+static const size_t NO_SLOT = static_cast<size_t>(-1);
+
+#if !defined(__AVR__)
+EmbedFSFileDevice::EmbedFSFileDevice(const char *path, uint32_t latency_us)
+    : file_(path ? fopen(path, "rb") : nullptr), latencyUs_(latency_us), reads_(0), bytesRead_(0) {}
+
+EmbedFSFileDevice::~EmbedFSFileDevice()
+{
+    if (file_)
+        fclose(file_);
+}
+
+bool EmbedFSFileDevice::read(uint32_t offset, uint8_t *buf, size_t size)
+{
+    if (!file_)
+        return false;
+    ++reads_;
+    bytesRead_ += size;
+    if (latencyUs_)
+        delayMicroseconds(latencyUs_);
+    if (fseek(file_, static_cast<long>(offset), SEEK_SET) != 0)
+        return false;
+    return fread(buf, 1, size, file_) == size;
+}
+#endif // !__AVR__
+
+EmbedFSBlockCache::EmbedFSBlockCache(EmbedFSBlockDevice &device, uint32_t limit, size_t block_size, size_t blocks)
+    : device_(device), limit_(limit), blockSize_(block_size ? block_size : 512), clock_(0), stats_{0, 0, 0}
+{
+    if (blocks == 0)
+        blocks = 1;
+    data_.assign(blocks * blockSize_, 0);
+    tags_.assign(blocks, 0);
+    lastUse_.assign(blocks, 0);
+}
+
+size_t EmbedFSBlockCache::find(uint32_t block) const
+{
+    for (size_t slot = 0; slot < tags_.size(); ++slot)
+    {
+        if (tags_[slot] == block + 1)
+            return slot;
+    }
+    return NO_SLOT;
+}
+
+// Read block into the least recently used slot; the last block may be short
+size_t EmbedFSBlockCache::fill(uint32_t block)
+{
+    size_t victim = 0;
+    for (size_t slot = 1; slot < tags_.size(); ++slot)
+    {
+        if (lastUse_[slot] < lastUse_[victim])
+            victim = slot;
+    }
+    uint32_t start = block * blockSize_;
+    size_t n = (limit_ - start < blockSize_) ? limit_ - start : blockSize_;
+    ++stats_.deviceReads;
+    if (!device_.read(start, &data_[victim * blockSize_], n))
+    {
+        tags_[victim] = 0;
+        return NO_SLOT;
+    }
+    ++stats_.misses;
+    tags_[victim] = block + 1;
+    return victim;
+}
+
+bool EmbedFSBlockCache::read(uint32_t offset, uint8_t *buf, size_t size)
+{
+    if (offset > limit_ || size > limit_ - offset)
+        return false;
+    uint32_t end = offset + size;
+    uint32_t pos = offset;
+    while (pos < end)
+    {
+        uint32_t block = pos / blockSize_;
+        size_t slot = find(block);
+        if (slot == NO_SLOT && pos == block * blockSize_ && end - pos >= blockSize_)
+        {
+            // coalesce the run of uncached whole blocks into one device read
+            uint32_t runEnd = pos + blockSize_;
+            while (end - runEnd >= blockSize_ && find(runEnd / blockSize_) == NO_SLOT)
+                runEnd += blockSize_;
+            ++stats_.deviceReads;
+            if (!device_.read(pos, buf + (pos - offset), runEnd - pos))
+                return false;
+            pos = runEnd;
+            continue;
+        }
+        if (slot == NO_SLOT)
+        {
+            slot = fill(block);
+            if (slot == NO_SLOT)
+                return false;
+        }
+        else
+        {
+            ++stats_.hits;
+        }
+        lastUse_[slot] = ++clock_;
+        uint32_t within = pos - block * blockSize_;
+        size_t n = blockSize_ - within;
+        if (n > end - pos)
+            n = end - pos;
+        memcpy(buf + (pos - offset), &data_[slot * blockSize_ + within], n);
+        pos += n;
+    }
+    return true;
+}
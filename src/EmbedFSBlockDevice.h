@@ -0,0 +1,123 @@
+/*
+  EmbedFSBlockDevice.h
+
+  Storage backends for packed images that are not memory-mapped (external SPI NOR, SD).
+  - EmbedFSBlockDevice: random-access read interface (offset, length)
+  - EmbedFSCallbackDevice: adapts a plain read callback, e.g. around esp_partition_read()
+  - EmbedFSFileDevice: stdio file (SD through the ESP32 VFS, or a host file) that counts
+    reads and can add a fixed latency per read for host benchmarks
+  - EmbedFSBlockCache: small LRU block cache with read coalescing in front of a device
+
+  Images for these backends are written by tools/embed_assets.py --emit image and mounted
+  with EmbedFSFS::begin(EmbedFSBlockDevice&, ...), which is not available on AVR.
+*/
+
+#ifndef EMBEDFS_BLOCK_DEVICE_H
+#define EMBEDFS_BLOCK_DEVICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <vector>
+
+namespace fs
+{
+
+    class EmbedFSBlockDevice
+    {
+    public:
+        virtual ~EmbedFSBlockDevice() {}
+
+        // Read size bytes at offset into buf; false on I/O error or short read
+        virtual bool read(uint32_t offset, uint8_t *buf, size_t size) = 0;
+    };
+
+    class EmbedFSCallbackDevice : public EmbedFSBlockDevice
+    {
+    public:
+        typedef bool (*ReadCallback)(void *context, uint32_t offset, uint8_t *buf, size_t size);
+
+        EmbedFSCallbackDevice(ReadCallback callback, void *context = nullptr) : callback_(callback), context_(context) {}
+
+        bool read(uint32_t offset, uint8_t *buf, size_t size) override
+        {
+            return callback_ && callback_(context_, offset, buf, size);
+        }
+
+    private:
+        ReadCallback callback_;
+        void *context_;
+    };
+
+#if !defined(__AVR__)
+    class EmbedFSFileDevice : public EmbedFSBlockDevice
+    {
+    public:
+        // latency_us is added to every read (0 for none)
+        explicit EmbedFSFileDevice(const char *path, uint32_t latency_us = 0);
+        ~EmbedFSFileDevice();
+
+        bool read(uint32_t offset, uint8_t *buf, size_t size) override;
+
+        bool isOpen() const { return file_ != nullptr; }
+        uint32_t reads() const { return reads_; }
+        uint32_t bytesRead() const { return bytesRead_; }
+        void resetStats()
+        {
+            reads_ = 0;
+            bytesRead_ = 0;
+        }
+
+    private:
+        FILE *file_;
+        uint32_t latencyUs_;
+        uint32_t reads_;
+        uint32_t bytesRead_;
+    };
+#endif
+
+    class EmbedFSBlockCache
+    {
+    public:
+        struct Stats
+        {
+            uint32_t hits;        // blocks served from the cache
+            uint32_t misses;      // blocks read into the cache
+            uint32_t deviceReads; // device read() calls
+        };
+
+        // limit: size of the device region reads may touch
+        EmbedFSBlockCache(EmbedFSBlockDevice &device, uint32_t limit, size_t block_size, size_t blocks);
+
+        // Read size bytes at offset. Cached blocks are copied; each run of uncached whole
+        // blocks is fetched with one device read straight into buf (and not cached, so a
+        // long stream does not evict small hot files); partial blocks go through the cache.
+        bool read(uint32_t offset, uint8_t *buf, size_t size);
+
+        Stats stats() const { return stats_; }
+        void resetStats() { stats_ = Stats{0, 0, 0}; }
+
+        // RAM held by the cache: this object and its blocks
+        size_t memoryUsage() const
+        {
+            return sizeof(*this) + data_.capacity() + (tags_.capacity() + lastUse_.capacity()) * sizeof(uint32_t);
+        }
+
+    private:
+        size_t find(uint32_t block) const;
+        size_t fill(uint32_t block);
+
+        EmbedFSBlockDevice &device_;
+        uint32_t limit_;
+        size_t blockSize_;
+        std::vector<uint8_t> data_;     // blocks * block_size bytes
+        std::vector<uint32_t> tags_;    // block number + 1, 0 = empty
+        std::vector<uint32_t> lastUse_; // LRU clock per slot
+        uint32_t clock_;
+        Stats stats_;
+    };
+
+} // namespace fs
+
+#endif // EMBEDFS_BLOCK_DEVICE_H
@@ -0,0 +1,65 @@
+/*
+  EmbedFSCacheSim.cpp
+  Set-associative LRU flash cache model; built only with EMBEDFS_CACHE_SIM.
+*/
+
+#if defined(EMBEDFS_CACHE_SIM)
+
+#include "EmbedFSCacheSim.h"
+
+using namespace fs;
+
+EmbedFSCacheSim *EmbedFSCacheSim::attached_ = nullptr;
+
+EmbedFSCacheSim::EmbedFSCacheSim(size_t line_size, size_t ways, size_t capacity)
+    : lineSize_(line_size ? line_size : 1), ways_(ways ? ways : 1), sets_(0), clock_(0), stats_{0, 0}
+{
+    sets_ = capacity / (lineSize_ * ways_);
+    if (sets_ == 0)
+        sets_ = 1;
+    tags_.assign(sets_ * ways_, 0);
+    lastUse_.assign(sets_ * ways_, 0);
+}
+
+void EmbedFSCacheSim::touch(const void *p, size_t n)
+{
+    if (!p || n == 0)
+        return;
+    uintptr_t first = reinterpret_cast<uintptr_t>(p) / lineSize_;
+    uintptr_t last = (reinterpret_cast<uintptr_t>(p) + n - 1) / lineSize_;
+    for (uintptr_t line = first; line <= last; ++line)
+    {
+        // tags store line + 1 so that 0 marks an empty way
+        size_t base = (line % sets_) * ways_;
+        size_t victim = base;
+        ++clock_;
+        ++stats_.accesses;
+        bool hit = false;
+        for (size_t way = base; way < base + ways_; ++way)
+        {
+            if (tags_[way] == line + 1)
+            {
+                lastUse_[way] = clock_;
+                hit = true;
+                break;
+            }
+            if (lastUse_[way] < lastUse_[victim])
+                victim = way;
+        }
+        if (hit)
+            continue;
+        ++stats_.misses;
+        tags_[victim] = line + 1;
+        lastUse_[victim] = clock_;
+    }
+}
+
+void EmbedFSCacheSim::flush()
+{
+    tags_.assign(tags_.size(), 0);
+    lastUse_.assign(lastUse_.size(), 0);
+}
+
+void EmbedFSCacheSim::attach(EmbedFSCacheSim *sim) { attached_ = sim; }
+
+#endif // EMBEDFS_CACHE_SIM
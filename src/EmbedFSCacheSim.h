@@ -0,0 +1,72 @@
+/*
+  EmbedFSCacheSim.h
+
+  Flash cache model for host-side layout benchmarks.
+  - Set-associative LRU cache with configurable line size, ways and capacity
+  - When EmbedFS is built with EMBEDFS_CACHE_SIM defined, every byte it reads from the
+    image (name and pointer tables, TOC, skip table, MIME ids, file data) is fed to the
+    attached simulator, so lookups, directory iteration and reads can be compared by
+    line misses as well as wall time
+  - Without EMBEDFS_CACHE_SIM the hooks compile away and EmbedFSCacheSim.cpp is empty
+*/
+
+#ifndef EMBEDFS_CACHE_SIM_H
+#define EMBEDFS_CACHE_SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace fs
+{
+
+    class EmbedFSCacheSim
+    {
+    public:
+        struct Stats
+        {
+            uint32_t accesses; // cache line lookups
+            uint32_t misses;   // lookups that had to fill a line
+        };
+
+        // Defaults are in the range of the ESP32 family's flash cache (32-byte lines).
+        // capacity is rounded down to a whole number of sets (line_size * ways bytes each).
+        explicit EmbedFSCacheSim(size_t line_size = 32, size_t ways = 4, size_t capacity = 16384);
+
+        // Record a read of n bytes at p
+        void touch(const void *p, size_t n);
+
+        Stats stats() const { return stats_; }
+        void resetStats() { stats_ = Stats{0, 0}; }
+        // Invalidate every line (cold cache) without touching the counters
+        void flush();
+
+        size_t lineSize() const { return lineSize_; }
+        size_t ways() const { return ways_; }
+        size_t sets() const { return sets_; }
+
+        // Simulator that receives EmbedFS reads; nullptr detaches
+        static void attach(EmbedFSCacheSim *sim);
+        static EmbedFSCacheSim *attached() { return attached_; }
+        static void touchAttached(const void *p, size_t n)
+        {
+            if (attached_)
+                attached_->touch(p, n);
+        }
+
+    private:
+        size_t lineSize_;
+        size_t ways_;
+        size_t sets_;
+        std::vector<uintptr_t> tags_;   // sets_ * ways_ line numbers, 0 = empty
+        std::vector<uint32_t> lastUse_; // LRU clock per way
+        uint32_t clock_;
+        Stats stats_;
+
+        static EmbedFSCacheSim *attached_;
+    };
+
+} // namespace fs
+
+#endif // EMBEDFS_CACHE_SIM_H
@@ -0,0 +1,1940 @@
+/*
+  EmbedFSCore.cpp
+  Mounting, lookup policies, listing and reading for EmbedFSCore; no Arduino dependency.
+*/
+
+#include "EmbedFSCore.h"
+#include "EmbedFSInflate.h"
+#include "EmbedFSMime.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+#if defined(EMBEDFS_INDEX_TASK)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+#if defined(EMBEDFS_CACHE_SIM)
+#include "EmbedFSCacheSim.h"
+#define EMBEDFS_TOUCH(p, n) EmbedFSCacheSim::touchAttached((p), (n))
+#else
+#define EMBEDFS_TOUCH(p, n) ((void)0)
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <utility>
+
+using namespace fs;
+
+// Byte/word access to generated data through the storage policy of the build (PROGMEM
+// on AVR). Every image read goes through these (or EMBEDFS_TOUCH directly) so
+// EmbedFSCacheSim sees it.
+typedef EmbedFSDefaultPolicy::Storage Storage;
+
+static inline uint8_t flashByte(const uint8_t *p) { return Storage::byte(p); }
+static inline uint32_t flashDword(const uint32_t *p) { return Storage::dword(p); }
+static inline void flashCopy(uint8_t *dst, const uint8_t *src, size_t n) { Storage::copy(dst, src, n); }
+
+void EmbedFSBackendStorage::copy(uint8_t *dst, const uint8_t *src, size_t n)
+{
+    EMBEDFS_TOUCH(src, n);
+    memcpy(dst, src, n);
+}
+
+// Decode one LEB128 varint (up to 32 bits) and advance p past it
+static inline uint32_t readVarint(const uint8_t *&p)
+{
+    uint32_t value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t b = flashByte(p++);
+        value |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            break;
+    }
+    return value;
+}
+
+// Name or request path without its leading '/' and trailing '/', as a pointer into name
+// and a length
+static const char *nameKey(const char *name, size_t &len)
+{
+    if (*name == '/')
+        ++name;
+    len = strlen(name);
+    while (len && name[len - 1] == '/')
+        --len;
+    return name;
+}
+
+static std::string normalizedName(const char *name)
+{
+    size_t len;
+    const char *key = nameKey(name, len);
+    return std::string(key, len);
+}
+
+// Normalized name equals key without building a string
+static bool sameName(const char *name, const char *key, size_t len)
+{
+    size_t nameLen;
+    const char *nk = nameKey(name, nameLen);
+    return nameLen == len && memcmp(nk, key, len) == 0;
+}
+
+// FNV-1a over a normalized name, for the path index
+static uint32_t nameHash(const char *key, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i)
+        h = (h ^ static_cast<uint8_t>(key[i])) * 16777619u;
+    return h;
+}
+
+// Serialized path index (writeIndex()), little-endian words:
+//   {magic, version, fileCount, slots, slotBytes, key low, key high}, then slots slot values
+#define EMBEDFS_INDEX_MAGIC 0x58534645u // "EFSX"
+#define EMBEDFS_INDEX_VERSION 1
+#define EMBEDFS_INDEX_HEADER_WORDS 7
+
+static void putLe32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+static uint32_t getLe32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Heap bytes of a string; short ones live inside the object (small string optimization)
+static size_t heapBytes(const std::string &s)
+{
+    const char *p = s.data();
+    const char *self = reinterpret_cast<const char *>(&s);
+    return (p >= self && p < self + sizeof(s)) ? 0 : s.capacity() + 1;
+}
+
+typedef std::vector<std::pair<uintptr_t, size_t>> Extents; // {start, length}
+
+// Bytes covered by extents, overlaps and repeats counted once; sorts extents by start
+static size_t coveredBytes(Extents &extents)
+{
+    std::sort(extents.begin(), extents.end());
+    size_t covered = 0;
+    uintptr_t end = 0;
+    for (const auto &e : extents)
+    {
+        uintptr_t start = std::max(e.first, end);
+        uintptr_t stop = e.first + e.second;
+        if (stop > start)
+        {
+            covered += stop - start;
+            end = stop;
+        }
+    }
+    return covered;
+}
+
+// Match name against pattern: '*' matches any run of characters (including '/'), '?' one
+static bool globMatch(const char *pattern, const char *name)
+{
+    const char *star = nullptr;
+    const char *resume = nullptr;
+    while (*name)
+    {
+        if (*pattern == '*')
+        {
+            star = pattern++;
+            resume = name;
+        }
+        else if (*pattern == '?' || *pattern == *name)
+        {
+            ++pattern;
+            ++name;
+        }
+        else if (star)
+        {
+            pattern = star + 1;
+            name = ++resume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (*pattern == '*')
+        ++pattern;
+    return *pattern == '\0';
+}
+
+static void *preloadAlloc(size_t size, PreloadMemory memory)
+{
+#if defined(ESP_PLATFORM)
+    if (memory == PreloadInternal)
+        return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (memory == PreloadPsram)
+        return heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    void *p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#else
+    (void)memory;
+    return malloc(size);
+#endif
+}
+
+static void preloadFree(void *p)
+{
+#if defined(ESP_PLATFORM)
+    heap_caps_free(p);
+#else
+    free(p);
+#endif
+}
+
+// ---------------- EmbedFSReader ----------------
+
+EmbedFSReader::EmbedFSReader()
+    : kind_(Closed), direct_(false), data_(nullptr), size_(0), pos_(0), cacheOffset_(0), extTable_(nullptr), extCount_(0),
+      extFirstData_(nullptr), extIndex_(0), extNext_(nullptr), extData_(nullptr), holeStart_(0), extStart_(0), extLen_(0),
+      coding_{EmbedFSArchive::Stored, 0, 0, 0}, started_(false), lastByte_(0) {}
+
+EmbedFSReader::~EmbedFSReader() {}
+
+EmbedFSReader::EmbedFSReader(const EmbedFSReader &other) : EmbedFSReader() { *this = other; }
+
+EmbedFSReader &EmbedFSReader::operator=(const EmbedFSReader &other)
+{
+    if (this == &other)
+        return *this;
+    kind_ = other.kind_;
+    direct_ = other.direct_;
+    data_ = other.data_;
+    size_ = other.size_;
+    pos_ = other.pos_;
+    owner_ = other.owner_;
+    cache_ = other.cache_;
+    cacheOffset_ = other.cacheOffset_;
+    extTable_ = other.extTable_;
+    extCount_ = other.extCount_;
+    extFirstData_ = other.extFirstData_;
+    extIndex_ = other.extIndex_;
+    extNext_ = other.extNext_;
+    extData_ = other.extData_;
+    holeStart_ = other.holeStart_;
+    extStart_ = other.extStart_;
+    extLen_ = other.extLen_;
+    coding_ = other.coding_;
+    started_ = false;
+    inflate_.reset();
+    return *this;
+}
+
+EmbedFSReader::EmbedFSReader(EmbedFSReader &&other) : EmbedFSReader() { *this = std::move(other); }
+
+EmbedFSReader &EmbedFSReader::operator=(EmbedFSReader &&other)
+{
+    if (this == &other)
+        return *this;
+    std::unique_ptr<EmbedFSInflate> inflate = std::move(other.inflate_);
+    bool started = other.started_;
+    *this = static_cast<const EmbedFSReader &>(other);
+    inflate_ = std::move(inflate);
+    started_ = started;
+    lastByte_ = other.lastByte_;
+    other.close();
+    return *this;
+}
+
+void EmbedFSReader::close()
+{
+    kind_ = Closed;
+    direct_ = false;
+    data_ = nullptr;
+    size_ = 0;
+    pos_ = 0;
+    owner_.reset();
+    cache_.reset();
+    inflate_.reset();
+}
+
+size_t EmbedFSReader::readSlow(uint8_t *buf, size_t size)
+{
+    if (kind_ == Closed || pos_ >= size_ || size == 0)
+        return 0;
+    size_t remaining = size_ - pos_;
+    size_t toRead = (size < remaining) ? size : remaining;
+    switch (kind_)
+    {
+    case Flash:
+        flashCopy(buf, data_ + pos_, toRead);
+        break;
+    case Ram:
+        memcpy(buf, data_ + pos_, toRead);
+        break;
+    case Device:
+        if (!cache_->read(cacheOffset_ + pos_, buf, toRead))
+            return 0;
+        break;
+    case Sparse:
+        toRead = readSparse(buf, toRead);
+        break;
+    case Deflate:
+        toRead = readInflated(buf, toRead);
+        break;
+    case Gzip:
+        toRead = readGzip(buf, toRead);
+        break;
+    default:
+        return 0;
+    }
+    pos_ += toRead;
+    return toRead;
+}
+
+int EmbedFSReader::peekSlow()
+{
+    uint8_t b;
+    if (!readSlow(&b, 1))
+        return -1;
+    --pos_; // deflate: served again from lastByte_ without restarting the decoder
+    return b;
+}
+
+size_t EmbedFSReader::readUntilSlow(char terminator, char *buf, size_t size)
+{
+    size_t len = 0;
+    while (len < size)
+    {
+        int c = read();
+        if (c < 0 || c == static_cast<uint8_t>(terminator))
+            break;
+        buf[len++] = static_cast<char>(c);
+    }
+    return len;
+}
+
+size_t EmbedFSReader::readSparse(uint8_t *buf, size_t size)
+{
+    size_t done = 0;
+    while (done < size)
+    {
+        size_t pos = pos_ + done;
+        sparseSeek(pos);
+        size_t n = size - done;
+        if (pos >= extStart_ && pos < extStart_ + extLen_)
+        {
+            size_t avail = extStart_ + extLen_ - pos;
+            if (n > avail)
+                n = avail;
+            flashCopy(buf + done, extData_ + (pos - extStart_), n);
+        }
+        else
+        {
+            // hole before the current extent, or after the last one
+            size_t holeEnd = (pos < extStart_) ? extStart_ : size_;
+            if (n > holeEnd - pos)
+                n = holeEnd - pos;
+            memset(buf + done, 0, n);
+        }
+        done += n;
+    }
+    return done;
+}
+
+void EmbedFSReader::sparseRewind()
+{
+    extIndex_ = 0;
+    extNext_ = extTable_;
+    extData_ = extFirstData_;
+    holeStart_ = 0;
+    extStart_ = 0;
+    extLen_ = 0;
+}
+
+void EmbedFSReader::sparseSeek(size_t pos)
+{
+    if (pos < holeStart_)
+        sparseRewind();
+    while (extStart_ + extLen_ <= pos && extIndex_ < extCount_)
+    {
+        holeStart_ = extStart_ + extLen_;
+        extData_ += extLen_;
+        extStart_ = holeStart_ + readVarint(extNext_);
+        extLen_ = readVarint(extNext_);
+        ++extIndex_;
+    }
+}
+
+// Decode up to pos_ first (discarding), then into buf; seeking backwards restarts decoding
+// except by the one byte peek() steps back
+size_t EmbedFSReader::readInflated(uint8_t *buf, size_t size)
+{
+    if (!inflate_)
+    {
+        inflate_.reset(new EmbedFSInflate());
+        started_ = false;
+    }
+    size_t done = 0;
+    if (started_ && inflate_->produced() == pos_ + 1)
+        buf[done++] = lastByte_;
+    size_t at = pos_ + done;
+    if (!started_ || inflate_->produced() > at)
+    {
+        inflate_->begin(data_, coding_.packedSize, coding_.rawSize);
+        started_ = true;
+    }
+    uint8_t skip[64];
+    while (inflate_->produced() < at)
+    {
+        size_t n = at - inflate_->produced();
+        if (inflate_->read(skip, n < sizeof(skip) ? n : sizeof(skip)) == 0)
+            return 0;
+    }
+    done += inflate_->read(buf + done, size - done);
+    if (done)
+        lastByte_ = buf[done - 1];
+    return done;
+}
+
+// gzip member: fixed 10-byte header, the raw stream, CRC-32 and size (little-endian), so
+// HTTP servers can send it with Content-Encoding: gzip
+size_t EmbedFSReader::readGzip(uint8_t *buf, size_t size)
+{
+    uint8_t trailer[8];
+    for (int i = 0; i < 4; ++i)
+    {
+        trailer[i] = static_cast<uint8_t>(coding_.crc32 >> (8 * i));
+        trailer[4 + i] = static_cast<uint8_t>(coding_.rawSize >> (8 * i));
+    }
+    static const uint8_t header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+    size_t done = 0;
+    while (done < size)
+    {
+        size_t pos = pos_ + done;
+        size_t n = size - done;
+        if (pos < sizeof(header))
+        {
+            n = std::min(n, sizeof(header) - pos);
+            memcpy(buf + done, header + pos, n);
+        }
+        else if (pos < sizeof(header) + coding_.packedSize)
+        {
+            n = std::min(n, sizeof(header) + coding_.packedSize - pos);
+            flashCopy(buf + done, data_ + (pos - sizeof(header)), n);
+        }
+        else
+        {
+            size_t at = pos - sizeof(header) - coding_.packedSize;
+            n = std::min(n, sizeof(trailer) - at);
+            memcpy(buf + done, trailer + at, n);
+        }
+        done += n;
+    }
+    return done;
+}
+
+// ---------------- EmbedFSCoreBase ----------------
+
+// Sequential reader over a packed TOC; see EmbedFSImage.h for the entry layout
+struct EmbedFSCoreBase::TocCursor
+{
+    const uint8_t *p;
+    uint32_t offset; // end of the previous blob-backed entry
+
+    // Inline entries point into the TOC, all others into the blob (nullptr blob: device
+    // images, where only offset is set)
+    EntryData next(const uint8_t *blob)
+    {
+        uint32_t head = readVarint(p);
+        EntryData entry = {nullptr, head >> EMBEDFS_TOC_FLAG_BITS, (head & EMBEDFS_TOC_SPARSE) != 0, false, 0, nullptr};
+        if (head & EMBEDFS_TOC_INLINE)
+        {
+            entry.data = p;
+            p += entry.size;
+            return entry;
+        }
+        uint32_t entryOffset = offset;
+        if (head & EMBEDFS_TOC_GAP)
+        {
+            uint32_t zz = readVarint(p);
+            entryOffset += (zz >> 1) ^ (0u - (zz & 1)); // zigzag, wraps for negative deltas
+        }
+        uint32_t stored = entry.sparse ? readVarint(p) : static_cast<uint32_t>(entry.size);
+        offset = entryOffset + stored;
+        entry.offset = entryOffset;
+        entry.data = blob ? blob + entryOffset : nullptr;
+        return entry;
+    }
+};
+
+EmbedFSCoreBase::EmbedFSCoreBase()
+    : names_(nullptr), data_(nullptr), sizes_(nullptr), count_(0), listedCount_(0), blob_(nullptr), toc_(nullptr),
+      tocSkip_(nullptr), skipInterval_(0), mimeIds_(nullptr), contentHashes_(nullptr), contentHashCount_(0), tagNames_(nullptr),
+      tagStarts_(nullptr), tagEntries_(nullptr), tagCount_(0), nameDict_(nullptr), nameBlocks_(nullptr), nameBlockSize_(0),
+      nameRanks_(nullptr), nameEntries_(nullptr), nameDigest_(0), nameRank_(npos), nameNext_(nullptr), blobOffset_(0),
+      preloadBytes_(0), profiling_(false), profileLimit_(0) {}
+
+EmbedFSCoreBase::~EmbedFSCoreBase() { end(); }
+
+bool EmbedFSCoreBase::begin(const char *const file_names[], const uint8_t *const file_data[], const size_t file_sizes[],
+                        size_t file_count, size_t listed_count)
+{
+    if (!file_names || !file_data || !file_sizes || file_count == 0)
+        return false;
+    end();
+    mountArrays(file_names, file_data, file_sizes, file_count, listed_count);
+    return true;
+}
+
+bool EmbedFSCoreBase::begin(const EmbedFSImage &image)
+{
+    bool dict = image.nameDict && image.nameBlocks && image.nameBlockSize;
+    if (image.version != EMBEDFS_IMAGE_VERSION || !(image.fileNames || dict) || !image.data || !image.toc || !image.tocSkip ||
+        image.skipInterval == 0 || image.fileCount == 0 || (dict && image.fileCount > 0xFFFF && image.nameRanks))
+        return false;
+    end();
+    mountImage(image);
+    return true;
+}
+
+#if !defined(__AVR__)
+// LEB128 varint of at most 5 bytes that ends before end; false otherwise
+static bool boundedVarint(const uint8_t *&p, const uint8_t *end, uint32_t &value)
+{
+    value = 0;
+    for (uint8_t shift = 0; shift < 35 && p < end; shift += 7)
+    {
+        uint8_t b = *p++;
+        value |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// Walk the TOC of a device image once, as TocCursor would: every entry and inline payload
+// must end inside the TOC, which must hold exactly count entries; blob-backed data must lie
+// inside the blob; each skip table slot must hold the cursor state at its entry. Device
+// images have no sparse entries (the generator does not emit them; the block cache reads
+// stored bytes only).
+static bool validDeviceToc(const uint8_t *toc, size_t tocSize, const std::vector<uint32_t> &skip, uint32_t skipInterval,
+                           uint32_t count, uint32_t blobSize)
+{
+    const uint8_t *p = toc;
+    const uint8_t *end = toc + tocSize;
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (i % skipInterval == 0)
+        {
+            size_t slot = i / skipInterval;
+            if (skip[slot * 2] != static_cast<uint32_t>(p - toc) || skip[slot * 2 + 1] != offset)
+                return false;
+        }
+        uint32_t head;
+        if (!boundedVarint(p, end, head) || (head & EMBEDFS_TOC_SPARSE))
+            return false;
+        uint32_t size = head >> EMBEDFS_TOC_FLAG_BITS;
+        if (head & EMBEDFS_TOC_INLINE)
+        {
+            if (size > static_cast<size_t>(end - p))
+                return false;
+            p += size;
+            continue;
+        }
+        uint32_t entryOffset = offset;
+        if (head & EMBEDFS_TOC_GAP)
+        {
+            uint32_t zz;
+            if (!boundedVarint(p, end, zz))
+                return false;
+            entryOffset += (zz >> 1) ^ (0u - (zz & 1));
+        }
+        if (entryOffset > blobSize || size > blobSize - entryOffset)
+            return false;
+        offset = entryOffset + size;
+    }
+    return p == end;
+}
+#endif
+
+// Load the index of a device image (see EmbedFSImage.h) into RAM; false if the header
+// does not describe a readable image or the TOC does not fit it
+bool EmbedFSCoreBase::begin(EmbedFSBlockDevice &device, size_t block_size, size_t cache_blocks)
+{
+#if defined(__AVR__)
+    // TOC reads go through pgm_read_byte, which cannot read a RAM index
+    (void)device;
+    (void)block_size;
+    (void)cache_blocks;
+    return false;
+#else
+    uint8_t raw[EMBEDFS_DEVICE_HEADER_WORDS * 4];
+    if (!device.read(0, raw, sizeof(raw)))
+        return false;
+    uint32_t h[EMBEDFS_DEVICE_HEADER_WORDS];
+    for (size_t i = 0; i < EMBEDFS_DEVICE_HEADER_WORDS; ++i)
+        h[i] = getLe32(raw + i * 4);
+    uint32_t fileCount = h[2], skipInterval = h[4], namesSize = h[5], tocSize = h[6], skipWords = h[7], mimeSize = h[8],
+             blobOffset = h[10], blobSize = h[11];
+    uint64_t indexEnd = sizeof(raw) + static_cast<uint64_t>(namesSize) + tocSize + skipWords * 4ull + mimeSize;
+    if (h[0] != EMBEDFS_DEVICE_MAGIC || h[1] != EMBEDFS_IMAGE_VERSION || fileCount == 0 || skipInterval == 0 ||
+        skipWords < ((fileCount + skipInterval - 1) / skipInterval) * 2 || (mimeSize && mimeSize != fileCount) ||
+        indexEnd > blobOffset || static_cast<uint64_t>(blobOffset) + blobSize > 0xFFFFFFFFull)
+        return false;
+
+    std::vector<uint8_t> index(namesSize + tocSize + mimeSize);
+    std::vector<uint8_t> skip(skipWords * 4);
+    if (!device.read(sizeof(raw), index.data(), namesSize + tocSize) ||
+        !device.read(sizeof(raw) + namesSize + tocSize, skip.data(), skip.size()) ||
+        !device.read(sizeof(raw) + namesSize + tocSize + skip.size(), index.data() + namesSize + tocSize, mimeSize))
+        return false;
+    // names are NUL-terminated back to back; the last one must end inside the table
+    std::vector<const char *> names;
+    const char *table = reinterpret_cast<const char *>(index.data());
+    for (size_t at = 0; at < namesSize && names.size() < fileCount;)
+    {
+        const char *nul = static_cast<const char *>(memchr(table + at, '\0', namesSize - at));
+        if (!nul)
+            break;
+        names.push_back(table + at);
+        at = nul - table + 1;
+    }
+    if (names.size() != fileCount)
+        return false;
+    std::vector<uint32_t> skipTable(skipWords);
+    for (size_t i = 0; i < skipWords; ++i)
+        skipTable[i] = getLe32(skip.data() + i * 4);
+    if (!validDeviceToc(index.data() + namesSize, tocSize, skipTable, skipInterval, fileCount, blobSize))
+        return false;
+
+    end();
+    deviceSkip_.swap(skipTable);
+    deviceIndex_ = std::make_shared<std::vector<uint8_t>>(std::move(index)); // the buffer moves, so names stay valid
+    deviceNames_.swap(names);
+    const uint8_t *toc = deviceIndex_->data() + namesSize;
+    mountImage(EmbedFSImage{EMBEDFS_IMAGE_VERSION, fileCount, deviceNames_.data(), nullptr, toc, deviceSkip_.data(),
+                            skipInterval, h[3], mimeSize ? toc + tocSize : nullptr, h[9], nullptr, 0, nullptr, 0,
+                            nullptr, nullptr, nullptr, 0, nullptr, nullptr, 0, nullptr, nullptr,
+                            h[12] | (static_cast<uint64_t>(h[13]) << 32)});
+    blobOffset_ = blobOffset;
+    cache_ = std::make_shared<EmbedFSBlockCache>(device, blobOffset + blobSize, block_size, cache_blocks);
+    return true;
+#endif
+}
+
+bool EmbedFSCoreBase::beginTar(const uint8_t *archive, size_t size)
+{
+#if defined(__AVR__)
+    // The index needs std::string paths and headers are read as RAM, not PROGMEM
+    (void)archive;
+    (void)size;
+    return false;
+#else
+    std::unique_ptr<EmbedFSArchive> index(new EmbedFSArchive());
+    if (!archive || !index->parseTar(archive, size))
+        return false;
+    return mountArchive(std::move(index));
+#endif
+}
+
+bool EmbedFSCoreBase::beginZip(const uint8_t *archive, size_t size)
+{
+#if defined(__AVR__)
+    (void)archive;
+    (void)size;
+    return false;
+#else
+    std::unique_ptr<EmbedFSArchive> index(new EmbedFSArchive());
+    if (!archive || !index->parseZip(archive, size))
+        return false;
+    return mountArchive(std::move(index));
+#endif
+}
+
+void EmbedFSCoreBase::end()
+{
+    unmounting();
+    clearPreload();
+    defaultDocs_.clear();
+    clearSearchPaths();
+    profile_.clear();
+    profiling_ = false;
+    profileLimit_ = 0;
+    names_ = nullptr;
+    data_ = nullptr;
+    sizes_ = nullptr;
+    count_ = 0;
+    listedCount_ = 0;
+    blob_ = nullptr;
+    toc_ = nullptr;
+    tocSkip_ = nullptr;
+    skipInterval_ = 0;
+    mimeIds_ = nullptr;
+    contentHashes_ = nullptr;
+    contentHashCount_ = 0;
+    tagNames_ = nullptr;
+    tagStarts_ = nullptr;
+    tagEntries_ = nullptr;
+    tagCount_ = 0;
+    nameDict_ = nullptr;
+    nameBlocks_ = nullptr;
+    nameBlockSize_ = 0;
+    nameRanks_ = nullptr;
+    nameEntries_ = nullptr;
+    nameDigest_ = 0;
+    std::string().swap(nameBuf_);
+    nameRank_ = npos;
+    nameNext_ = nullptr;
+    deviceIndex_.reset(); // freed with the last reader of an inline entry
+    deviceNames_.clear();
+    deviceSkip_.clear();
+    cache_.reset();
+    blobOffset_ = 0;
+    archive_.reset();
+}
+
+void EmbedFSCoreBase::mountArrays(const char *const *names, const uint8_t *const *data, const size_t *sizes, size_t count,
+                              size_t listed)
+{
+    names_ = names;
+    data_ = data;
+    sizes_ = sizes;
+    count_ = count;
+    listedCount_ = (listed && listed < count) ? listed : count;
+}
+
+void EmbedFSCoreBase::mountImage(const EmbedFSImage &image)
+{
+    names_ = image.fileNames;
+    count_ = image.fileCount;
+    listedCount_ = (image.listedCount && image.listedCount < image.fileCount) ? image.listedCount : image.fileCount;
+    blob_ = image.data;
+    toc_ = image.toc;
+    tocSkip_ = image.tocSkip;
+    skipInterval_ = image.skipInterval;
+    // ids numbered by another MIME table would name the wrong types; use extensions then
+    mimeIds_ = image.mimeTable == EmbedFSMime::tableHash() ? image.mimeIds : nullptr;
+    contentHashes_ = image.contentHashes;
+    contentHashCount_ = image.contentHashes ? image.contentHashCount : 0;
+    bool tags = image.tagNames && image.tagStarts && image.tagEntries;
+    tagNames_ = tags ? image.tagNames : nullptr;
+    tagStarts_ = tags ? image.tagStarts : nullptr;
+    tagEntries_ = tags ? image.tagEntries : nullptr;
+    tagCount_ = tags ? image.tagCount : 0;
+    nameDigest_ = image.fileNames ? image.nameDigest : 0;
+    if (!image.fileNames && image.nameDict && image.nameBlocks && image.nameBlockSize)
+    {
+        nameDict_ = image.nameDict;
+        nameBlocks_ = image.nameBlocks;
+        nameBlockSize_ = image.nameBlockSize;
+        nameRanks_ = image.nameEntries ? image.nameRanks : nullptr;
+        nameEntries_ = image.nameRanks ? image.nameEntries : nullptr;
+    }
+}
+
+// The archive's name/data/size arrays stay owned by the core
+bool EmbedFSCoreBase::mountArchive(std::unique_ptr<EmbedFSArchive> archive)
+{
+    if (archive->fileCount() == 0)
+        return false;
+    end();
+    mountArrays(archive->fileNames(), archive->fileData(), archive->fileSizes(), archive->fileCount(), archive->listedCount());
+    archive_ = std::move(archive);
+    return true;
+}
+
+// 16-bit little-endian value i of a front-coded name rank table
+static inline size_t nameTableAt(const uint8_t *table, size_t i)
+{
+    return flashByte(table + 2 * i) | (static_cast<size_t>(flashByte(table + 2 * i + 1)) << 8);
+}
+
+// Entry name; the pointer slot and the string are image reads
+const char *EmbedFSCoreBase::nameAt(size_t i) const
+{
+    if (nameDict_)
+        return decodeName(nameRanks_ ? nameTableAt(nameRanks_, i) : i);
+    EMBEDFS_TOUCH(names_ + i, sizeof(*names_));
+    const char *name = names_[i];
+#if defined(EMBEDFS_CACHE_SIM)
+    if (name)
+        EMBEDFS_TOUCH(name, strlen(name) + 1);
+#endif
+    return name;
+}
+
+// Name at sorted position rank into nameBuf_: from the block head, or from the last decoded
+// name when rank follows it in the same block, so walking the entries in name order decodes
+// each name once
+const char *EmbedFSCoreBase::decodeName(size_t rank) const
+{
+    size_t block = rank / nameBlockSize_;
+    const uint8_t *p;
+    size_t at;
+    if (nameRank_ != npos && nameRank_ <= rank && nameRank_ / nameBlockSize_ == block)
+    {
+        p = nameNext_;
+        at = nameRank_;
+    }
+    else
+    {
+        p = nameDict_ + flashDword(nameBlocks_ + block);
+        nameBuf_.clear();
+        for (uint8_t c; (c = flashByte(p++)) != 0;)
+            nameBuf_.push_back(static_cast<char>(c));
+        at = block * nameBlockSize_;
+    }
+    for (; at < rank; ++at)
+    {
+        nameBuf_.resize(readVarint(p));
+        for (uint8_t c; (c = flashByte(p++)) != 0;)
+            nameBuf_.push_back(static_cast<char>(c));
+    }
+    nameRank_ = rank;
+    nameNext_ = p;
+    return nameBuf_.c_str();
+}
+
+// Compare the NUL-terminated name at p, from byte from on, with key[from, len): the sign of
+// the comparison, with the bytes both share from the start in *shared; p is left past the NUL
+static int compareName(const uint8_t *&p, size_t from, const char *key, size_t len, size_t *shared)
+{
+    size_t i = from;
+    int cmp = 0;
+    uint8_t c;
+    for (; (c = flashByte(p++)) != 0; ++i)
+    {
+        if (cmp != 0)
+            continue;
+        uint8_t k = i < len ? static_cast<uint8_t>(key[i]) : 0;
+        if (c != k)
+        {
+            cmp = c < k ? -1 : 1;
+            *shared = i;
+        }
+    }
+    if (cmp == 0)
+    {
+        *shared = i;
+        cmp = i < len ? -1 : 0;
+    }
+    return cmp;
+}
+
+// Bisect for the last block whose head is not above key, then walk its names tracking the
+// bytes the current name shares with key: a name sharing more with its predecessor than
+// that is still below key, one sharing less is already above it, so only names sharing
+// exactly that many bytes are compared, from that byte on
+size_t EmbedFSCoreBase::findName(const char *key, size_t len) const
+{
+    size_t blocks = (count_ + nameBlockSize_ - 1) / nameBlockSize_;
+    size_t first = 0;
+    size_t last = blocks;
+    size_t shared = 0;
+    while (first < last)
+    {
+        size_t mid = first + (last - first) / 2;
+        const uint8_t *p = nameDict_ + flashDword(nameBlocks_ + mid);
+        int cmp = compareName(p, 0, key, len, &shared);
+        if (cmp == 0)
+            return nameEntries_ ? nameTableAt(nameEntries_, mid * nameBlockSize_) : mid * nameBlockSize_;
+        if (cmp < 0)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    if (first == 0)
+        return npos;
+    size_t block = first - 1;
+    const uint8_t *p = nameDict_ + flashDword(nameBlocks_ + block);
+    compareName(p, 0, key, len, &shared);
+    size_t end = std::min(count_, (block + 1) * nameBlockSize_);
+    for (size_t rank = block * nameBlockSize_ + 1; rank < end; ++rank)
+    {
+        size_t common = readVarint(p);
+        if (common < shared)
+            return npos;
+        if (common > shared)
+        {
+            while (flashByte(p++) != 0)
+                ;
+            continue;
+        }
+        int cmp = compareName(p, common, key, len, &shared);
+        if (cmp == 0)
+            return nameEntries_ ? nameTableAt(nameEntries_, rank) : rank;
+        if (cmp > 0)
+            return npos;
+    }
+    return npos;
+}
+
+// Resolve entry data; packed images decode at most skipInterval_ TOC entries
+EmbedFSCoreBase::EntryData EmbedFSCoreBase::entryAt(size_t index) const
+{
+    if (!preloaded_.empty())
+    {
+        auto it = std::lower_bound(preloaded_.begin(), preloaded_.end(), index,
+                                   [](const Preloaded &p, size_t entry) { return p.entry < entry; });
+        if (it != preloaded_.end() && it->entry == index)
+            return EntryData{preloadBlock_.get() + it->offset, it->size, false, true, 0, nullptr};
+    }
+    return flashEntryAt(index);
+}
+
+EmbedFSCoreBase::EntryData EmbedFSCoreBase::flashEntryAt(size_t index) const
+{
+    if (!toc_)
+    {
+        EMBEDFS_TOUCH(data_ + index, sizeof(*data_));
+        EMBEDFS_TOUCH(sizes_ + index, sizeof(*sizes_));
+        return EntryData{data_[index], sizes_[index], false, false, 0, archive_ ? archive_->coding(index) : nullptr};
+    }
+    size_t slot = index / skipInterval_;
+    TocCursor cursor = {toc_ + flashDword(tocSkip_ + slot * 2), flashDword(tocSkip_ + slot * 2 + 1)};
+    for (size_t i = slot * skipInterval_; i < index; ++i)
+        cursor.next(blob_);
+    return cursor.next(blob_);
+}
+
+void EmbedFSCoreBase::openEntry(const EntryData &entry, EmbedFSReader &reader) const
+{
+    reader.close();
+    reader.data_ = entry.data;
+    reader.size_ = entry.size;
+    // RAM the entry's bytes live in, held so the reader outlives end() and remounts
+    if (entry.ram)
+        reader.owner_ = preloadBlock_;
+    else if (cache_ && entry.data)
+        reader.owner_ = deviceIndex_;
+    if (cache_ && !entry.data)
+    {
+        reader.kind_ = EmbedFSReader::Device;
+        reader.cache_ = cache_;
+        reader.cacheOffset_ = blobOffset_ + entry.offset;
+    }
+    else if (!entry.data)
+    {
+        reader.size_ = 0;
+    }
+    else if (entry.coding)
+    {
+        bool gzip = entry.coding->encoding == EmbedFSArchive::Gzip;
+        reader.kind_ = gzip ? EmbedFSReader::Gzip : EmbedFSReader::Deflate;
+        reader.coding_ = *entry.coding;
+        reader.size_ = gzip ? entry.coding->packedSize + 18 : entry.coding->rawSize;
+        reader.started_ = false;
+    }
+    else if (entry.sparse)
+    {
+        reader.kind_ = EmbedFSReader::Sparse;
+        const uint8_t *p = entry.data;
+        reader.extCount_ = readVarint(p);
+        reader.extTable_ = p;
+        for (uint32_t i = 0; i < reader.extCount_ * 2; ++i)
+            readVarint(p);
+        reader.extFirstData_ = p;
+        reader.sparseRewind();
+    }
+    else
+    {
+        // device image entries with data are inline in the RAM copy of the TOC
+        reader.kind_ = (entry.ram || cache_) ? EmbedFSReader::Ram : EmbedFSReader::Flash;
+        // PROGMEM needs pgm_read_*; the cache model must see every image read
+        reader.direct_ = reader.kind_ == EmbedFSReader::Ram || Storage::direct;
+    }
+}
+
+bool EmbedFSCoreBase::open(size_t entry, EmbedFSReader &reader)
+{
+    if (entry >= count_)
+    {
+        reader.close();
+        return false;
+    }
+    recordAccess(entry);
+    openEntry(entryAt(entry), reader);
+    return reader.isOpen();
+}
+
+size_t EmbedFSCoreBase::totalBytes() const
+{
+    size_t sum = 0;
+    if (!toc_)
+    {
+        EMBEDFS_TOUCH(sizes_, listedCount_ * sizeof(*sizes_));
+        for (size_t i = 0; i < listedCount_; ++i)
+            sum += sizes_[i];
+        return sum;
+    }
+    TocCursor cursor = {toc_, 0};
+    for (size_t i = 0; i < listedCount_; ++i)
+        sum += cursor.next(blob_).size;
+    return sum;
+}
+
+// Map each directory to its first existing default document (in the order of
+// documents), so opening a directory resolves with one binary search instead of
+// one lookup per candidate name.
+void EmbedFSCoreBase::setDefaultDocuments(const char *const documents[], size_t count)
+{
+    defaultDocs_.clear();
+    for (size_t i = 0; i < count_ && documents; ++i)
+    {
+        const char *name = nameAt(i);
+        if (!name)
+            continue;
+        std::string fn = normalizedName(name);
+        size_t slash = fn.rfind('/');
+        const char *base = fn.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+        for (size_t rank = 0; rank < count; ++rank)
+        {
+            if (documents[rank] && strcmp(base, documents[rank]) == 0)
+            {
+                defaultDocs_.push_back({slash == std::string::npos ? std::string() : fn.substr(0, slash), i, rank});
+                break;
+            }
+        }
+    }
+    std::sort(defaultDocs_.begin(), defaultDocs_.end(), [](const DefaultDocument &a, const DefaultDocument &b) {
+        return a.dir != b.dir ? a.dir < b.dir : a.rank < b.rank;
+    });
+    defaultDocs_.erase(std::unique(defaultDocs_.begin(), defaultDocs_.end(),
+                                   [](const DefaultDocument &a, const DefaultDocument &b) { return a.dir == b.dir; }),
+                       defaultDocs_.end());
+    defaultDocs_.shrink_to_fit();
+}
+
+const char *EmbedFSCoreBase::pathKey(const char *path, size_t &len) { return nameKey(path, len); }
+
+bool EmbedFSCoreBase::nameIs(size_t entry, const char *key, size_t len) const
+{
+    const char *name = entry < count_ ? nameAt(entry) : nullptr;
+    return name && sameName(name, key, len);
+}
+
+size_t EmbedFSCoreBase::scan(const char *key, size_t len) const
+{
+    for (size_t i = 0; i < count_; ++i)
+    {
+        const char *name = nameAt(i);
+        if (name && sameName(name, key, len))
+            return i;
+    }
+    return npos;
+}
+
+size_t EmbedFSCoreBase::findDefaultDocument(const char *path) const
+{
+    if (!path || !count_)
+        return npos;
+    size_t len;
+    const char *key = nameKey(path, len);
+    auto doc = std::lower_bound(defaultDocs_.begin(), defaultDocs_.end(), 0, [key, len](const DefaultDocument &d, int) {
+        return d.dir.compare(0, std::string::npos, key, len) < 0;
+    });
+    return (doc != defaultDocs_.end() && doc->dir.compare(0, std::string::npos, key, len) == 0) ? doc->entry : npos;
+}
+
+// Index every entry under each root by its name relative to that root, so resolving a name
+// against the roots hashes it once and probes one table per root, instead of building and
+// looking up root + name for each of them
+void EmbedFSCoreBase::setSearchPaths(const char *const roots[], size_t count, size_t cache_slots)
+{
+    clearSearchPaths();
+    if (!roots || !count_)
+        return;
+    std::vector<uint32_t> slots;
+    std::vector<std::pair<uint32_t, uint32_t>> members; // {relative name hash, entry}
+    for (size_t r = 0; r < count; ++r)
+    {
+        SearchRoot root = {roots[r] ? normalizedName(roots[r]) : std::string(), slots.size(), 1};
+        size_t dirLen = root.dir.size();
+        members.clear();
+        for (size_t i = 0; i < count_; ++i)
+        {
+            const char *name = nameAt(i);
+            if (!name)
+                continue;
+            size_t len;
+            const char *key = nameKey(name, len);
+            if (dirLen && (len <= dirLen + 1 || key[dirLen] != '/' || memcmp(key, root.dir.data(), dirLen) != 0))
+                continue;
+            size_t skip = dirLen ? dirLen + 1 : 0;
+            members.push_back({nameHash(key + skip, len - skip), static_cast<uint32_t>(i)});
+        }
+        while (root.slots < members.size() + members.size() / 2 + 1)
+            root.slots <<= 1;
+        slots.resize(root.first + root.slots, 0);
+        uint32_t *table = slots.data() + root.first;
+        for (const auto &m : members) // in entry order: the first of duplicate names wins
+        {
+            size_t slot = m.first & (root.slots - 1);
+            while (table[slot])
+                slot = (slot + 1) & (root.slots - 1);
+            table[slot] = m.second + 1;
+        }
+        searchRoots_.push_back(std::move(root));
+    }
+    if (count_ < 0xFFFF)
+        searchSlots16_.assign(slots.begin(), slots.end());
+    else
+        searchSlots32_.swap(slots);
+    size_t cacheSize = 0;
+    if (cache_slots)
+    {
+        cacheSize = 1;
+        while (cacheSize < cache_slots)
+            cacheSize <<= 1;
+    }
+    searchCache_.assign(cacheSize, SearchCacheSlot{0, 0, 0});
+    searchRoots_.shrink_to_fit();
+}
+
+void EmbedFSCoreBase::clearSearchPaths()
+{
+    std::vector<SearchRoot>().swap(searchRoots_);
+    std::vector<uint16_t>().swap(searchSlots16_);
+    std::vector<uint32_t>().swap(searchSlots32_);
+    std::vector<SearchCacheSlot>().swap(searchCache_);
+}
+
+// Normalized name of entry, known to lie under root, is root/key
+bool EmbedFSCoreBase::relativeNameIs(size_t entry, const SearchRoot &root, const char *key, size_t len) const
+{
+    const char *name = entry < count_ ? nameAt(entry) : nullptr;
+    if (!name)
+        return false;
+    size_t nameLen;
+    const char *nk = nameKey(name, nameLen);
+    size_t skip = root.dir.empty() ? 0 : root.dir.size() + 1;
+    return nameLen == skip + len && memcmp(nk + skip, key, len) == 0;
+}
+
+size_t EmbedFSCoreBase::findInSearchPaths(const char *name, size_t *root) const
+{
+    if (root)
+        *root = npos;
+    if (!name || searchRoots_.empty())
+        return npos;
+    size_t len;
+    const char *key = nameKey(name, len);
+    if (!len)
+        return npos;
+    uint32_t h = nameHash(key, len);
+    SearchCacheSlot *cached = searchCache_.empty() ? nullptr : &searchCache_[h & (searchCache_.size() - 1)];
+    if (cached && cached->entry && cached->hash == h && relativeNameIs(cached->entry - 1, searchRoots_[cached->root], key, len))
+    {
+        if (root)
+            *root = cached->root;
+        return cached->entry - 1;
+    }
+    for (size_t r = 0; r < searchRoots_.size(); ++r)
+    {
+        const SearchRoot &sr = searchRoots_[r];
+        size_t mask = sr.slots - 1;
+        for (size_t slot = h & mask, v; (v = searchSlot(sr.first + slot)) != 0; slot = (slot + 1) & mask)
+        {
+            if (!relativeNameIs(v - 1, sr, key, len))
+                continue;
+            if (cached)
+                *cached = SearchCacheSlot{h, static_cast<uint32_t>(v), static_cast<uint32_t>(r)};
+            if (root)
+                *root = r;
+            return v - 1;
+        }
+    }
+    return npos;
+}
+
+// Hash of content hash triple i
+static uint64_t contentHashAt(const uint32_t *table, size_t i)
+{
+    return (static_cast<uint64_t>(flashDword(table + i * 3)) << 32) | flashDword(table + i * 3 + 1);
+}
+
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Bisect the triples for the range of hashes starting with the prefix; an unambiguous range
+// holds one hash (several entries only for identical files, the first wins)
+size_t EmbedFSCoreBase::findByHash(const char *hex) const
+{
+    if (!hex || !contentHashes_)
+        return npos;
+    uint64_t prefix = 0;
+    size_t digits = 0;
+    for (int v; digits < 16 && (v = hexValue(hex[digits])) >= 0; ++digits)
+        prefix = (prefix << 4) | static_cast<uint64_t>(v);
+    if (digits == 0)
+        return npos;
+    unsigned shift = static_cast<unsigned>(64 - 4 * digits); // 0 to 60
+    uint64_t low = prefix << shift;
+    uint64_t high = low | ((static_cast<uint64_t>(1) << shift) - 1);
+    if (contentHashCount_ == 0)
+        return npos;
+    // lower bound of low; the halving does not depend on the compares, which become
+    // conditional moves instead of mispredicted branches
+    size_t first = 0;
+    for (size_t len = contentHashCount_; len > 1; len -= len / 2)
+        first = contentHashAt(contentHashes_, first + len / 2) < low ? first + len / 2 : first;
+    if (contentHashAt(contentHashes_, first) < low && ++first == contentHashCount_)
+        return npos;
+    uint64_t hash = contentHashAt(contentHashes_, first);
+    if (hash > high)
+        return npos;
+    // past the copies of identical files, the next hash must be outside the range
+    size_t next = first + 1;
+    while (next < contentHashCount_ && contentHashAt(contentHashes_, next) == hash)
+        ++next;
+    if (next < contentHashCount_ && contentHashAt(contentHashes_, next) <= high)
+        return npos;
+    size_t entry = flashDword(contentHashes_ + first * 3 + 2);
+    return entry < count_ ? entry : npos;
+}
+
+size_t EmbedFSCoreBase::findTag(const char *name) const
+{
+    if (!name)
+        return npos;
+    size_t first = 0;
+    size_t last = tagCount_;
+    while (first < last)
+    {
+        size_t mid = first + (last - first) / 2;
+        int cmp = strcmp(tagNames_[mid], name);
+        if (cmp == 0)
+            return mid;
+        if (cmp < 0)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    return npos;
+}
+
+// First position in list[pos, end) holding an entry not below entry: steps of 1, 2, 4, ...
+// then a bisect of the last step, so k seeks through a group of m cost O(k log(m / k))
+static size_t gallop(const uint32_t *list, size_t pos, size_t end, uint32_t entry)
+{
+    if (pos == end || flashDword(list + pos) >= entry)
+        return pos;
+    size_t step = 1;
+    while (pos + step < end && flashDword(list + pos + step) < entry)
+    {
+        pos += step;
+        step <<= 1;
+    }
+    size_t last = std::min(pos + step, end);
+    ++pos;
+    while (pos < last)
+    {
+        size_t mid = pos + (last - pos) / 2;
+        if (flashDword(list + mid) < entry)
+            pos = mid + 1;
+        else
+            last = mid;
+    }
+    return pos;
+}
+
+bool EmbedFSCoreBase::tagged(const char *const tags[], size_t count, std::vector<uint32_t> &entries) const
+{
+    entries.clear();
+    if (!tags || count == 0)
+        return false;
+    struct Group
+    {
+        size_t pos; // into tagEntries_
+        size_t end;
+    };
+    std::vector<Group> groups(count);
+    for (size_t t = 0; t < count; ++t)
+    {
+        size_t tag = findTag(tags[t]);
+        if (tag == npos)
+            return false;
+        groups[t] = {flashDword(tagStarts_ + tag), flashDword(tagStarts_ + tag + 1)};
+    }
+    std::sort(groups.begin(), groups.end(), [](const Group &a, const Group &b) { return a.end - a.pos < b.end - b.pos; });
+    Group &smallest = groups[0];
+    entries.reserve(smallest.end - smallest.pos);
+    for (; smallest.pos < smallest.end; ++smallest.pos)
+    {
+        uint32_t entry = flashDword(tagEntries_ + smallest.pos);
+        bool all = entry < count_;
+        for (size_t g = 1; g < count && all; ++g)
+        {
+            groups[g].pos = gallop(tagEntries_, groups[g].pos, groups[g].end, entry);
+            all = groups[g].pos < groups[g].end && flashDword(tagEntries_ + groups[g].pos) == entry;
+        }
+        if (all)
+            entries.push_back(entry);
+    }
+    return true;
+}
+
+bool EmbedFSCoreBase::isDirectory(const char *key, size_t len) const
+{
+    for (size_t i = 0; i < listedCount_; ++i)
+    {
+        const char *name = nameAt(i);
+        if (!name)
+            continue;
+        size_t nameLen;
+        const char *fn = nameKey(name, nameLen);
+        if (nameLen > len + 1 && fn[len] == '/' && memcmp(fn, key, len) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool EmbedFSCoreBase::list(const char *path, std::vector<DirEntry> &entries) const
+{
+    entries.clear();
+    if (!path || !count_)
+        return false;
+    size_t len;
+    const char *key = nameKey(path, len);
+    auto addUnique = [&entries](std::string &&child, bool isDir) {
+        for (auto &entry : entries)
+        {
+            if (entry.path == child)
+            {
+                if (isDir && !entry.isDir)
+                    entry.isDir = true;
+                return;
+            }
+        }
+        entries.push_back({std::move(child), isDir});
+    };
+
+    for (size_t i = 0; i < listedCount_; ++i)
+    {
+        const char *name = nameAt(i);
+        if (!name)
+            continue;
+        size_t nameLen;
+        const char *fn = nameKey(name, nameLen);
+        if (len)
+        {
+            if (nameLen <= len + 1 || fn[len] != '/' || memcmp(fn, key, len) != 0)
+                continue;
+            fn += len + 1;
+            nameLen -= len + 1;
+        }
+        if (nameLen == 0)
+            continue;
+        const char *slash = static_cast<const char *>(memchr(fn, '/', nameLen));
+        bool isDir = slash != nullptr;
+        std::string child(1, '/');
+        if (len)
+            child.append(key, len).append(1, '/');
+        child.append(fn, isDir ? static_cast<size_t>(slash - fn) : nameLen);
+        addUnique(std::move(child), isDir);
+    }
+    return !entries.empty() || len == 0;
+}
+
+uint8_t EmbedFSCoreBase::mimeIdOf(size_t entry, const char *path) const
+{
+    if (mimeIds_ && entry < count_)
+        return flashByte(mimeIds_ + entry);
+    return path ? EmbedFSMime::idFromPath(path) : 0;
+}
+
+// Copy every entry matching patterns into one block, in a single pass over the
+// entries. Entries that share bytes (aliases) share one copy. Sparse entries are
+// expanded, so RAM reads are plain memcpy.
+void EmbedFSCoreBase::setPreload(const char *const patterns[], size_t count, PreloadMemory memory)
+{
+    clearPreload();
+#if !defined(__AVR__)
+    struct Source
+    {
+        const uint8_t *data;
+        uint32_t offset; // data/offset/coding as resolved by flashEntryAt()
+        const EmbedFSArchive::Coding *coding;
+        size_t copy; // offset of the copy in the block
+    };
+    std::vector<Source> sources;
+    size_t total = 0;
+    for (size_t i = 0; i < count_ && patterns; ++i)
+    {
+        const char *name = nameAt(i);
+        if (!name)
+            continue;
+        std::string path = std::string("/") + normalizedName(name);
+        bool match = false;
+        for (size_t k = 0; k < count && !match; ++k)
+            match = patterns[k] && globMatch((std::string("/") + normalizedName(patterns[k])).c_str(), path.c_str());
+        if (!match)
+            continue;
+        EntryData entry = flashEntryAt(i);
+        auto source = std::find_if(sources.begin(), sources.end(), [&entry](const Source &s) {
+            return s.data == entry.data && s.offset == entry.offset && s.coding == entry.coding;
+        });
+        size_t offset = (source != sources.end()) ? source->copy : total;
+        if (source == sources.end())
+        {
+            sources.push_back({entry.data, entry.offset, entry.coding, total});
+            total += (entry.size + 3) & ~static_cast<size_t>(3);
+        }
+        preloaded_.push_back({i, offset, entry.size});
+    }
+    if (preloaded_.empty())
+        return;
+    uint8_t *block = static_cast<uint8_t *>(preloadAlloc(total ? total : 1, memory));
+    if (!block)
+    {
+        preloaded_.clear();
+        return;
+    }
+    preloadBlock_.reset(block, preloadFree);
+    EmbedFSReader reader;
+    for (const Preloaded &p : preloaded_)
+    {
+        openEntry(flashEntryAt(p.entry), reader);
+        reader.read(block + p.offset, p.size);
+    }
+    preloadBytes_ = total;
+    preloaded_.shrink_to_fit();
+#else
+    (void)patterns;
+    (void)count;
+    (void)memory;
+#endif
+}
+
+void EmbedFSCoreBase::clearPreload()
+{
+    preloadBlock_.reset(); // freed with the last reader of a preloaded file
+    preloadBytes_ = 0;
+    preloaded_.clear();
+}
+
+// Flash by mount type, with the generator's layouts (tools/embed_assets.py prints the same
+// categories):
+//   arrays: one array per file (4-byte aligned, the padding is estimated), names, data
+//           pointers and sizes
+//   packed: blob (alignment gaps are padding), TOC (inline file bytes count as data),
+//           skip table, MIME ids, names
+//   device: packed layout with a header and names but no pointer array in the image;
+//           the gap before the blob is padding
+//   archive: file bytes (deflate streams for compressed entries); the rest of the
+//           archive (headers, directories) is index
+EmbedFSFootprint EmbedFSCoreBase::footprint() const
+{
+    EmbedFSFootprint fp = {};
+    fp.engine = sizeof(EmbedFSCoreBase) + defaultDocs_.capacity() * sizeof(DefaultDocument) +
+                profile_.capacity() * sizeof(ProfileEntry);
+    for (const DefaultDocument &doc : defaultDocs_)
+        fp.engine += heapBytes(doc.dir);
+    fp.engine += searchRoots_.capacity() * sizeof(SearchRoot) + searchSlots16_.capacity() * 2 + searchSlots32_.capacity() * 4 +
+                 searchCache_.capacity() * sizeof(SearchCacheSlot);
+    for (const SearchRoot &root : searchRoots_)
+        fp.engine += heapBytes(root.dir);
+    fp.engine += heapBytes(nameBuf_);
+    fp.preload = preloadBytes_ + preloaded_.capacity() * sizeof(Preloaded);
+    fp.inflate = EmbedFSInflate::liveBytes();
+    if (!count_)
+        return fp;
+
+    Extents extents;
+    extents.reserve(count_);
+    if (archive_)
+    {
+        for (size_t i = 0; i < count_; ++i)
+        {
+            const EmbedFSArchive::Coding *coding = archive_->coding(i);
+            extents.push_back({reinterpret_cast<uintptr_t>(data_[i]), coding ? coding->packedSize : sizes_[i]});
+        }
+        fp.fileData = coveredBytes(extents);
+        fp.index = archive_->archiveSize() - fp.fileData;
+        fp.mount = archive_->memoryUsage();
+        return fp;
+    }
+
+    if (nameDict_)
+    {
+        size_t blocks = (count_ + nameBlockSize_ - 1) / nameBlockSize_;
+        fp.names = flashDword(nameBlocks_ + blocks) + (blocks + 1) * sizeof(uint32_t) + (nameRanks_ ? count_ * 4 : 0);
+    }
+    for (size_t i = 0; i < count_ && names_; ++i)
+    {
+        if (!cache_)
+            fp.names += sizeof(*names_);
+        if (names_[i])
+            fp.names += strlen(names_[i]) + 1;
+    }
+    if (!toc_)
+    {
+        for (size_t i = 0; i < count_; ++i)
+            extents.push_back({reinterpret_cast<uintptr_t>(data_[i]), sizes_[i]});
+        fp.fileData = coveredBytes(extents);
+        for (size_t i = 0; i < extents.size(); ++i)
+        {
+            if (i == 0 || extents[i].first != extents[i - 1].first)
+                fp.padding += (0 - std::max<size_t>(extents[i].second, 1)) & 3;
+        }
+        fp.index = count_ * (sizeof(*data_) + sizeof(*sizes_));
+        return fp;
+    }
+
+    TocCursor cursor = {toc_, 0};
+    size_t inlineBytes = 0;
+    uint32_t blobEnd = 0;
+    for (size_t i = 0; i < count_; ++i)
+    {
+        EntryData entry = cursor.next(blob_);
+        if (entry.data && entry.data >= toc_ && entry.data <= cursor.p)
+        {
+            inlineBytes += entry.size;
+            continue;
+        }
+        uint32_t stored = cursor.offset - entry.offset;
+        extents.push_back({entry.offset, stored});
+        blobEnd = std::max(blobEnd, cursor.offset);
+    }
+    size_t covered = coveredBytes(extents);
+    size_t tocBytes = static_cast<size_t>(cursor.p - toc_);
+    fp.fileData = inlineBytes + covered;
+    fp.padding = blobEnd - covered;
+    fp.index = tocBytes - inlineBytes + (mimeIds_ ? count_ : 0) + contentHashCount_ * 3 * sizeof(uint32_t);
+    if (tagCount_)
+    {
+        for (size_t t = 0; t < tagCount_; ++t)
+            fp.index += sizeof(*tagNames_) + strlen(tagNames_[t]) + 1;
+        fp.index += (tagCount_ + 1 + flashDword(tagStarts_ + tagCount_)) * sizeof(uint32_t);
+    }
+    if (cache_)
+    {
+        size_t indexEnd = EMBEDFS_DEVICE_HEADER_WORDS * 4 + deviceIndex_->size() + deviceSkip_.size() * 4;
+        fp.index += EMBEDFS_DEVICE_HEADER_WORDS * 4 + deviceSkip_.size() * 4;
+        fp.padding += blobOffset_ - indexEnd;
+        fp.mount = deviceIndex_->capacity() + deviceNames_.capacity() * sizeof(const char *) +
+                   deviceSkip_.capacity() * sizeof(uint32_t);
+        fp.cache = cache_->memoryUsage();
+    }
+    else
+    {
+        fp.index += (count_ + skipInterval_ - 1) / skipInterval_ * 2 * sizeof(uint32_t);
+    }
+    return fp;
+}
+
+size_t EmbedFSCoreBase::writeFootprint(const EmbedFSFootprint &fp, WriteCallback write, void *context)
+{
+    const struct
+    {
+        const char *key;
+        size_t value;
+    } lines[] = {{"flash.data", fp.fileData},  {"flash.padding", fp.padding}, {"flash.names", fp.names},
+                 {"flash.index", fp.index},    {"flash.total", fp.flash()},   {"ram.lookup", fp.lookup},
+                 {"ram.mount", fp.mount},      {"ram.cache", fp.cache},       {"ram.preload", fp.preload},
+                 {"ram.engine", fp.engine},    {"ram.files", fp.files},       {"ram.slots", fp.slots},
+                 {"ram.dirs", fp.dirs},        {"ram.inflate", fp.inflate},   {"ram.total", fp.ram()},
+                 {"open.files", fp.openFiles}, {"open.dirs", fp.openDirs}};
+    if (!write)
+        return 0;
+    char buf[40];
+    for (const auto &line : lines)
+    {
+        int len = snprintf(buf, sizeof(buf), "%s %lu\r\n", line.key, static_cast<unsigned long>(line.value));
+        write(context, reinterpret_cast<const uint8_t *>(buf), static_cast<size_t>(len));
+    }
+    return sizeof(lines) / sizeof(lines[0]);
+}
+
+size_t EmbedFSCoreBase::listingBytes(const std::vector<DirEntry> &entries)
+{
+    size_t bytes = entries.capacity() * sizeof(DirEntry);
+    for (const DirEntry &entry : entries)
+        bytes += heapBytes(entry.path);
+    return bytes;
+}
+
+void EmbedFSCoreBase::startProfile(size_t max_entries)
+{
+    profile_.clear();
+    profile_.reserve(max_entries < count_ ? max_entries : count_);
+    profileLimit_ = max_entries;
+    profiling_ = true;
+}
+
+size_t EmbedFSCoreBase::writeProfile(WriteCallback write, void *context) const
+{
+    if (!write)
+        return 0;
+    char count[16];
+    for (const ProfileEntry &e : profile_)
+    {
+        snprintf(count, sizeof(count), "%lu /", static_cast<unsigned long>(e.count));
+        std::string line = count + normalizedName(nameAt(e.entry)) + "\r\n";
+        write(context, reinterpret_cast<const uint8_t *>(line.data()), line.size());
+    }
+    return profile_.size();
+}
+
+// Count an open of entry i; a linear scan is fine next to the name scan of a lookup
+void EmbedFSCoreBase::recordAccess(size_t i)
+{
+    if (!profiling_)
+        return;
+    for (ProfileEntry &e : profile_)
+    {
+        if (e.entry == i)
+        {
+            ++e.count;
+            return;
+        }
+    }
+    if (profile_.size() < profileLimit_)
+        profile_.push_back({static_cast<uint32_t>(i), 1});
+}
+
+// ---------------- EmbedFSSortedLookup ----------------
+
+size_t EmbedFSSortedLookup::find(const EmbedFSCoreBase &core, const char *key, size_t len) const
+{
+    if (mode_ != IndexOff && !ready_)
+        build(core);
+    if (!ready_)
+        return core.scan(key, len);
+    return order16_.empty() ? search(core, order32_, key, len) : search(core, order16_, key, len);
+}
+
+void EmbedFSSortedLookup::setIndex(const EmbedFSCoreBase &core, IndexMode mode, const uint8_t *, size_t)
+{
+    reset();
+    mode_ = mode;
+    if (mode == IndexEager && core.mounted())
+        build(core);
+}
+
+void EmbedFSSortedLookup::reset()
+{
+    mode_ = IndexOff;
+    ready_ = false;
+    order16_.clear();
+    order16_.shrink_to_fit();
+    order32_.clear();
+    order32_.shrink_to_fit();
+}
+
+void EmbedFSSortedLookup::build(const EmbedFSCoreBase &core) const
+{
+    if (!core.mounted())
+        return;
+    if (core.fileCount() < 0xFFFF)
+        fill(core, order16_);
+    else
+        fill(core, order32_);
+    ready_ = true;
+}
+
+// Named entries by normalized name, duplicates in entry order so the first of them is
+// found first, as with the scan. Keys are resolved once into a temporary array so the
+// sort compares without strlen().
+template <typename Slot>
+void EmbedFSSortedLookup::fill(const EmbedFSCoreBase &core, std::vector<Slot> &order) const
+{
+    struct Named
+    {
+        const char *key;
+        size_t len;
+        Slot entry;
+    };
+    std::vector<Named> named;
+    named.reserve(core.fileCount());
+    for (size_t i = 0; i < core.fileCount(); ++i)
+    {
+        const char *name = core.fileName(i);
+        if (!name)
+            continue;
+        size_t len;
+        const char *key = nameKey(name, len);
+        named.push_back({key, len, static_cast<Slot>(i)});
+    }
+    std::sort(named.begin(), named.end(), [](const Named &a, const Named &b) {
+        int c = memcmp(a.key, b.key, std::min(a.len, b.len));
+        if (c != 0)
+            return c < 0;
+        return a.len != b.len ? a.len < b.len : a.entry < b.entry;
+    });
+    order.resize(named.size());
+    for (size_t i = 0; i < named.size(); ++i)
+        order[i] = named[i].entry;
+}
+
+template <typename Slot>
+size_t EmbedFSSortedLookup::search(const EmbedFSCoreBase &core, const std::vector<Slot> &order, const char *key,
+                                   size_t len) const
+{
+    auto it = std::lower_bound(order.begin(), order.end(), 0, [&core, key, len](Slot entry, int) {
+        size_t nameLen;
+        const char *name = nameKey(core.fileName(entry), nameLen);
+        int c = memcmp(name, key, std::min(nameLen, len));
+        return c != 0 ? c < 0 : nameLen < len;
+    });
+    if (it == order.end() || !core.nameIs(*it, key, len))
+        return EmbedFSCoreBase::npos;
+    return *it;
+}
+
+// ---------------- EmbedFSHashLookup ----------------
+
+EmbedFSHashLookup::EmbedFSHashLookup() : mode_(IndexOff), state_(Idle), cancel_(false), core_(nullptr) {}
+
+EmbedFSHashLookup::~EmbedFSHashLookup() { reset(); }
+
+// Index of the file named key, scanning the names until the index is ready
+size_t EmbedFSHashLookup::find(const EmbedFSCoreBase &core, const char *key, size_t len) const
+{
+    if (mode_ == IndexLazy && state_ == Idle)
+        build(core);
+    if (state_ == Ready)
+        return index16_.empty() ? probe(core, index32_, key, len) : probe(core, index16_, key, len);
+    return core.scan(key, len);
+}
+
+void EmbedFSHashLookup::setIndex(const EmbedFSCoreBase &core, IndexMode mode, const uint8_t *saved, size_t saved_size)
+{
+    reset();
+    mode_ = mode;
+    if (!core.mounted() || (saved && adopt(core, saved, saved_size)))
+        return;
+    if (mode == IndexEager)
+    {
+        build(core);
+    }
+    else if (mode == IndexBackground)
+    {
+        core_ = &core;
+#if defined(EMBEDFS_INDEX_TASK)
+        state_ = Building;
+#if portNUM_PROCESSORS > 1
+        BaseType_t cpu = xPortGetCoreID() ? 0 : 1;
+#else
+        BaseType_t cpu = tskNO_AFFINITY;
+#endif
+        if (xTaskCreatePinnedToCore(task, "embedfs_index", 4096, this, 1, nullptr, cpu) != pdPASS)
+        {
+            state_ = Idle;
+            mode_ = IndexLazy;
+        }
+#elif defined(EMBEDFS_INDEX_THREAD)
+        state_ = Building;
+        thread_ = std::thread([this] { build(*core_); });
+#else
+        mode_ = IndexLazy;
+#endif
+    }
+}
+
+size_t EmbedFSHashLookup::write(const EmbedFSCoreBase &core, EmbedFSCoreBase::WriteCallback write, void *context) const
+{
+    if (!write || !core.mounted() || state_ == Building)
+        return 0;
+    if (state_ != Ready)
+        build(core);
+    bool narrow = !index16_.empty();
+    size_t slots = narrow ? index16_.size() : index32_.size();
+    uint64_t key = nameTableKey(core);
+    uint8_t header[EMBEDFS_INDEX_HEADER_WORDS * 4];
+    uint32_t words[EMBEDFS_INDEX_HEADER_WORDS] = {EMBEDFS_INDEX_MAGIC, EMBEDFS_INDEX_VERSION, static_cast<uint32_t>(core.fileCount()),
+                                                  static_cast<uint32_t>(slots), narrow ? 2u : 4u,
+                                                  static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)};
+    for (size_t i = 0; i < EMBEDFS_INDEX_HEADER_WORDS; ++i)
+        putLe32(header + i * 4, words[i]);
+    size_t written = write(context, header, sizeof(header));
+    uint8_t chunk[64];
+    size_t used = 0;
+    for (size_t i = 0; i < slots; ++i)
+    {
+        uint32_t v = narrow ? index16_[i] : index32_[i];
+        chunk[used++] = static_cast<uint8_t>(v);
+        chunk[used++] = static_cast<uint8_t>(v >> 8);
+        if (!narrow)
+        {
+            chunk[used++] = static_cast<uint8_t>(v >> 16);
+            chunk[used++] = static_cast<uint8_t>(v >> 24);
+        }
+        if (used == sizeof(chunk) || i + 1 == slots)
+        {
+            written += write(context, chunk, used);
+            used = 0;
+        }
+    }
+    return written;
+}
+
+// 64-bit FNV-1a over the names as stored (NUL-terminated) and their count; a saved
+// index is only valid for the exact name table it was built from. Packed and device
+// images carry the same digest from the generator, so adopting skips hashing the names.
+uint64_t EmbedFSHashLookup::nameTableKey(const EmbedFSCoreBase &core)
+{
+    if (core.nameDigest())
+        return core.nameDigest();
+    size_t count = core.fileCount();
+    uint64_t h = 14695981039346656037ull ^ count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const char *c = core.fileName(i);
+        if (!c)
+            c = "";
+        do
+            h = (h ^ static_cast<uint8_t>(*c)) * 1099511628211ull;
+        while (*c++);
+    }
+    return h;
+}
+
+// Copy a writeIndex() blob in when it matches this name table; every slot is checked
+// so a damaged blob cannot index past the entries or make probing loop forever
+bool EmbedFSHashLookup::adopt(const EmbedFSCoreBase &core, const uint8_t *blob, size_t size)
+{
+    const size_t headerBytes = EMBEDFS_INDEX_HEADER_WORDS * 4;
+    size_t count = core.fileCount();
+    if (size < headerBytes || getLe32(blob) != EMBEDFS_INDEX_MAGIC || getLe32(blob + 4) != EMBEDFS_INDEX_VERSION ||
+        getLe32(blob + 8) != count)
+        return false;
+    size_t slots = getLe32(blob + 12);
+    size_t width = getLe32(blob + 16);
+    if (slots <= count || (slots & (slots - 1)) != 0 || width != (count < 0xFFFF ? 2u : 4u) ||
+        (size - headerBytes) / width != slots || (size - headerBytes) % width != 0)
+        return false;
+    uint64_t key = getLe32(blob + 20) | (static_cast<uint64_t>(getLe32(blob + 24)) << 32);
+    if (key != nameTableKey(core))
+        return false;
+    const uint8_t *p = blob + headerBytes;
+    std::vector<uint16_t> narrow;
+    std::vector<uint32_t> wide;
+    size_t used = 0;
+    if (width == 2)
+        narrow.resize(slots);
+    else
+        wide.resize(slots);
+    for (size_t i = 0; i < slots; ++i, p += width)
+    {
+        uint32_t v = (width == 2) ? static_cast<uint32_t>(p[0] | (p[1] << 8)) : getLe32(p);
+        if (v > count)
+            return false;
+        used += (v != 0);
+        if (width == 2)
+            narrow[i] = static_cast<uint16_t>(v);
+        else
+            wide[i] = v;
+    }
+    if (used > count)
+        return false;
+    index16_.swap(narrow);
+    index32_.swap(wide);
+    state_ = Ready;
+    return true;
+}
+
+// Stop a background build; the index stays empty until the next build
+void EmbedFSHashLookup::cancel()
+{
+    cancel_ = true;
+#if defined(EMBEDFS_INDEX_TASK)
+    while (state_ == Building)
+        vTaskDelay(1);
+#elif defined(EMBEDFS_INDEX_THREAD)
+    if (thread_.joinable())
+        thread_.join();
+#endif
+    cancel_ = false;
+    if (state_ != Ready)
+        state_ = Idle;
+}
+
+void EmbedFSHashLookup::reset()
+{
+    cancel();
+    mode_ = IndexOff;
+    state_ = Idle;
+    core_ = nullptr;
+    index16_.clear();
+    index16_.shrink_to_fit();
+    index32_.clear();
+    index32_.shrink_to_fit();
+}
+
+#if defined(EMBEDFS_INDEX_TASK)
+void EmbedFSHashLookup::task(void *arg)
+{
+    EmbedFSHashLookup *self = static_cast<EmbedFSHashLookup *>(arg);
+    self->build(*self->core_);
+    vTaskDelete(nullptr);
+}
+#endif
+
+// Open-addressing table (linear probing, load <= 2/3) of entry + 1 over the normalized
+// names; 16-bit slots while entry numbers fit. Entries are inserted in order, so the
+// first of duplicate names is found first, as with the scan.
+void EmbedFSHashLookup::build(const EmbedFSCoreBase &core) const
+{
+    size_t count = core.fileCount();
+    size_t slots = 1;
+    while (slots < count + count / 2 + 1)
+        slots <<= 1;
+    std::vector<uint16_t> narrow;
+    std::vector<uint32_t> wide;
+    bool done = (count < 0xFFFF) ? fill(core, narrow, slots) : fill(core, wide, slots);
+    if (done)
+    {
+        index16_.swap(narrow);
+        index32_.swap(wide);
+    }
+    state_ = done ? Ready : Idle;
+}
+
+template <typename Slot>
+bool EmbedFSHashLookup::fill(const EmbedFSCoreBase &core, std::vector<Slot> &table, size_t slots) const
+{
+    table.assign(slots, 0);
+    for (size_t i = 0; i < core.fileCount(); ++i)
+    {
+        if ((i & 255) == 0 && cancel_)
+            return false;
+        const char *name = core.fileName(i);
+        if (!name)
+            continue;
+        size_t len;
+        const char *key = nameKey(name, len);
+        size_t slot = nameHash(key, len) & (slots - 1);
+        while (table[slot])
+            slot = (slot + 1) & (slots - 1);
+        table[slot] = static_cast<Slot>(i + 1);
+    }
+    return true;
+}
+
+template <typename Slot>
+size_t EmbedFSHashLookup::probe(const EmbedFSCoreBase &core, const std::vector<Slot> &table, const char *key, size_t len) const
+{
+    size_t mask = table.size() - 1;
+    for (size_t slot = nameHash(key, len) & mask; table[slot]; slot = (slot + 1) & mask)
+    {
+        size_t i = table[slot] - 1;
+        if (core.nameIs(i, key, len))
+            return i;
+    }
+    return EmbedFSCoreBase::npos;
+}
@@ -0,0 +1,640 @@
+/*
+  EmbedFSCore.h
+
+  Dependency-free EmbedFS engine with a plain C++ API (no Arduino, FS or String).
+  - EmbedFSCore: mounts generated arrays, packed images, device images and archives;
+    path index, lookup, directory listing, preload and access profile
+  - EmbedFSReader: read cursor over one file (flash, RAM, sparse, device, deflate or
+    gzip), without virtual dispatch
+  - EmbedFSFS (EmbedFS.h) is a thin FS adapter over this core; the core can also be
+    used directly, e.g. from ESP-IDF components, other frameworks or host benchmarks
+
+  EmbedFSCore is BasicEmbedFSCore<Lookup> with the lookup of the target's preset
+  (EmbedFSPolicy.h); other lookups can be instantiated side by side.
+
+  Paths are accepted with or without a leading '/'; trailing '/' is ignored.
+*/
+
+#ifndef EMBEDFS_CORE_H
+#define EMBEDFS_CORE_H
+
+#include "EmbedFSImage.h"
+#include "EmbedFSBlockDevice.h"
+#include "EmbedFSArchive.h"
+#include "EmbedFSPolicy.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(ESP_PLATFORM)
+#define EMBEDFS_INDEX_TASK 1 // IndexBackground on a FreeRTOS task
+#elif !defined(ARDUINO)
+#define EMBEDFS_INDEX_THREAD 1 // host builds: IndexBackground on a std::thread
+#endif
+#if defined(EMBEDFS_INDEX_TASK) || defined(EMBEDFS_INDEX_THREAD)
+#include <atomic>
+#endif
+#if defined(EMBEDFS_INDEX_THREAD)
+#include <thread>
+#endif
+
+namespace fs
+{
+
+    class EmbedFSInflate;
+
+    // Heap used by setPreload(). Only ESP32 distinguishes internal RAM and PSRAM;
+    // elsewhere every value means plain malloc().
+    enum PreloadMemory
+    {
+        PreloadAny,      // PSRAM when present, else internal RAM
+        PreloadInternal, // internal RAM (also usable while the flash cache is disabled)
+        PreloadPsram
+    };
+
+    // Path lookup index for setIndex(). Without it every lookup scans the names; the
+    // index is a hash table of 2-4 bytes per slot (about 3-6 bytes per file).
+    enum IndexMode
+    {
+        IndexOff,       // scan the names (default, no RAM)
+        IndexEager,     // build inside begin()
+        IndexLazy,      // build on the first lookup
+        IndexBackground // build on a task on the other core (ESP32; a thread in host builds,
+                        // else like IndexLazy); lookups scan until it is ready
+    };
+
+    // Flash and RAM taken by EmbedFS, from EmbedFSCore::footprint() and EmbedFSFS::footprint().
+    // Flash is the mounted data wherever it lives (program flash, a RAM buffer, the device
+    // region); RAM is what EmbedFS allocated for it. The last group counts live objects of
+    // every mount in the program; the core fills inflate, EmbedFSFS adds Files and
+    // directories.
+    struct EmbedFSFootprint
+    {
+        // Flash
+        size_t fileData; // file contents; bytes shared by aliases and duplicates count once
+        size_t padding;  // alignment between files (estimated for arrays) and before a device blob
+        size_t names;    // path strings and the pointer array to them
+        size_t index;    // sizes, offsets, TOC, skip table, MIME ids; headers of an archive
+        // RAM held by this mount
+        size_t lookup;  // path index (setIndex()), once built
+        size_t mount;   // device image index or archive index
+        size_t cache;   // device block cache
+        size_t preload; // setPreload() copies
+        size_t engine;  // engine object, default documents and access profile
+        // RAM held by live objects of every mount
+        size_t files;   // open Files with their paths
+        size_t slots;   // free handle slots of EmbedFSPoolHandles/EmbedFSStaticHandles
+        size_t dirs;    // open directories with their listings
+        size_t inflate; // deflate decoders and their windows
+        size_t openFiles;
+        size_t openDirs;
+
+        size_t flash() const { return fileData + padding + names + index; }
+        size_t ram() const { return lookup + mount + cache + preload + engine + files + slots + dirs + inflate; }
+    };
+
+    // Read cursor over one file, filled in by EmbedFSCore::open(). Device files keep the
+    // block cache alive and preloaded files their RAM copy; every other kind points into
+    // the mounted data. Files whose bytes
+    // are directly addressable (RAM copies, and image data outside AVR) are read inline;
+    // the other kinds go through one out-of-line call per read.
+    class EmbedFSReader
+    {
+    public:
+        EmbedFSReader();
+        ~EmbedFSReader();
+        // A copy reads the same file from the same position; a deflate decoder is not
+        // copied but restarted on the copy's first read
+        EmbedFSReader(const EmbedFSReader &other);
+        EmbedFSReader &operator=(const EmbedFSReader &other);
+        EmbedFSReader(EmbedFSReader &&other);
+        EmbedFSReader &operator=(EmbedFSReader &&other);
+
+        // Read up to size bytes at the current position
+        size_t read(uint8_t *buf, size_t size)
+        {
+            if (!direct_)
+                return readSlow(buf, size);
+            size_t n = (size < size_ - pos_) ? size : size_ - pos_;
+            memcpy(buf, data_ + pos_, n);
+            pos_ += n;
+            return n;
+        }
+        // Next byte, or -1 at the end
+        int read()
+        {
+            if (direct_)
+                return pos_ < size_ ? data_[pos_++] : -1;
+            uint8_t b;
+            return readSlow(&b, 1) ? b : -1;
+        }
+        // Next byte without consuming it, or -1 at the end
+        int peek()
+        {
+            if (direct_)
+                return pos_ < size_ ? data_[pos_] : -1;
+            return peekSlow();
+        }
+        // Copy bytes into buf until terminator (consumed, not stored), the end of the file
+        // or size bytes, like Stream::readBytesUntil(); returns the bytes stored
+        size_t readUntil(char terminator, char *buf, size_t size)
+        {
+            if (!direct_)
+                return readUntilSlow(terminator, buf, size);
+            size_t n = (size < size_ - pos_) ? size : size_ - pos_;
+            const uint8_t *at = data_ + pos_;
+            const uint8_t *hit = static_cast<const uint8_t *>(memchr(at, terminator, n));
+            size_t len = hit ? static_cast<size_t>(hit - at) : n;
+            memcpy(buf, at, len);
+            pos_ += hit ? len + 1 : len;
+            return len;
+        }
+        size_t available() const { return size_ - pos_; }
+        // Move to pos; false past the end
+        bool seek(size_t pos)
+        {
+            if (kind_ == Closed || pos > size_)
+                return false;
+            pos_ = pos;
+            return true;
+        }
+        size_t position() const { return pos_; }
+        size_t size() const { return size_; }
+        bool isOpen() const { return kind_ != Closed; }
+        void close();
+
+    private:
+        friend class EmbedFSCoreBase;
+
+        enum Kind : uint8_t
+        {
+            Closed,
+            Flash,   // image data (PROGMEM on AVR)
+            Ram,     // preloaded copy or device index
+            Sparse,  // extent table in image data
+            Device,  // device image through the block cache
+            Deflate, // raw deflate stream, inflated on read
+            Gzip     // raw deflate stream served as a gzip member
+        };
+
+        size_t readSlow(uint8_t *buf, size_t size);
+        int peekSlow();
+        size_t readUntilSlow(char terminator, char *buf, size_t size);
+        size_t readSparse(uint8_t *buf, size_t size);
+        size_t readInflated(uint8_t *buf, size_t size);
+        size_t readGzip(uint8_t *buf, size_t size);
+        void sparseRewind();
+        void sparseSeek(size_t pos);
+
+        Kind kind_;
+        bool direct_; // data_ can be dereferenced: read inline
+        const uint8_t *data_;
+        size_t size_;
+        size_t pos_;
+        // Ram/Sparse: the RAM data_ points into (preload block or device index), so the
+        // reader outlives end() and remounts
+        std::shared_ptr<const void> owner_;
+        // Device
+        std::shared_ptr<EmbedFSBlockCache> cache_;
+        uint32_t cacheOffset_;
+        // Sparse: cursor on the extent table; sequential reads walk it forward and a
+        // backward seek past the current hole restarts from the first extent
+        const uint8_t *extTable_;
+        uint32_t extCount_;
+        const uint8_t *extFirstData_;
+        uint32_t extIndex_;
+        const uint8_t *extNext_;
+        const uint8_t *extData_;
+        size_t holeStart_;
+        size_t extStart_;
+        size_t extLen_;
+        // Deflate / Gzip
+        EmbedFSArchive::Coding coding_;
+        bool started_;
+        uint8_t lastByte_; // last inflated byte, for reading again after peek()
+        std::unique_ptr<EmbedFSInflate> inflate_; // Deflate only; allocates its window on the first read
+    };
+
+    // Mounting, entries, listing, reading, preload and profile: everything but the path
+    // lookup, which BasicEmbedFSCore adds from its Lookup policy
+    class EmbedFSCoreBase
+    {
+    public:
+        static const size_t npos = static_cast<size_t>(-1);
+
+        // Child of a listed directory
+        struct DirEntry
+        {
+            std::string path; // absolute path starting with '/'
+            bool isDir;
+        };
+
+        // Output sink for writeIndex()/writeProfile(); returns the bytes accepted
+        typedef size_t (*WriteCallback)(void *context, const uint8_t *data, size_t size);
+
+        EmbedFSCoreBase();
+        virtual ~EmbedFSCoreBase();
+
+        // Mount variants, as EmbedFSFS::begin()/beginTar()/beginZip(); each replaces the
+        // current mount on success and leaves it untouched on failure. The index, default
+        // documents and preload start empty.
+        bool begin(const char *const file_names[], const uint8_t *const file_data[], const size_t file_sizes[], size_t file_count,
+                   size_t listed_count = 0);
+        bool begin(const EmbedFSImage &image);
+        bool begin(EmbedFSBlockDevice &device, size_t block_size = 512, size_t cache_blocks = 8);
+        bool beginTar(const uint8_t *archive, size_t size);
+        bool beginZip(const uint8_t *archive, size_t size);
+        void end();
+        bool mounted() const { return count_ != 0; }
+
+        // nullptr for images with front-coded names; fileName() works for every mount
+        const char *const *fileNames() const { return names_; }
+        size_t fileCount() const { return count_; }
+        // Entries at or after listedCount() (hidden aliases) are left out of listings
+        size_t listedCount() const { return listedCount_; }
+        // Name of entry as stored (with or without the leading '/'). With front-coded names
+        // it is decoded into a buffer that the next call reuses.
+        const char *fileName(size_t entry) const { return entry < count_ ? nameAt(entry) : nullptr; }
+        // The image stores front-coded names (--name-blocks); lookups then search them
+        // directly and the lookup policy's index is not used
+        bool hasNameDictionary() const { return nameDict_ != nullptr; }
+        // Digest of the names recorded by the generator (packed and device images), or 0
+        uint64_t nameDigest() const { return nameDigest_; }
+
+        // Path without its leading and trailing '/', as a pointer into path and a length:
+        // the key that lookups compare against normalized entry names
+        static const char *pathKey(const char *path, size_t &len);
+        // Normalized name of entry equals key (false for a bad or unnamed entry)
+        bool nameIs(size_t entry, const char *key, size_t len) const;
+        // First entry named key by scanning the names, or npos
+        size_t scan(const char *key, size_t len) const;
+        // First entry named key in the front-coded names (bisect the block heads, then walk
+        // one block without rebuilding names), or npos. O(log n) with no RAM.
+        size_t findName(const char *key, size_t len) const;
+
+        // Entry of the default document of directory path (setDefaultDocuments()), or npos
+        size_t findDefaultDocument(const char *path) const;
+        // Entry of name resolved against the search paths (setSearchPaths()): the first root,
+        // in order, holding root/name, with that root's position in *root (npos when none
+        // does). One hash of name, then one table probe per root; a cached resolution
+        // costs one name compare. The cache makes this unsafe to call from two tasks at once.
+        size_t findInSearchPaths(const char *name, size_t *root = nullptr) const;
+        size_t searchPathCount() const { return searchRoots_.size(); }
+        // Entry whose content hash (--content-hash) starts with the hex digits at hex (up to
+        // 16, read until the first other character); npos without a hash table, when no
+        // file matches or when the prefix matches files with different contents. O(log n).
+        size_t findByHash(const char *hex) const;
+        // Tags of a packed image generated with manifest "tags", sorted by name
+        size_t tagCount() const { return tagCount_; }
+        const char *tagName(size_t tag) const { return tag < tagCount_ ? tagNames_[tag] : nullptr; }
+        // Tag named name, or npos
+        size_t findTag(const char *name) const;
+        // Entries carrying every tag in tags (one tag: its whole group), ascending; false when
+        // a name is not a tag. Walks the smallest group and gallops through the others, so the
+        // cost follows the group sizes, not the file count.
+        bool tagged(const char *const tags[], size_t count, std::vector<uint32_t> &entries) const;
+        // Children of directory path in first-seen order; false when path is neither the
+        // root nor the prefix of a listed entry
+        bool list(const char *path, std::vector<DirEntry> &entries) const;
+
+        // Point reader at entry (preloaded copy when there is one) and count the open for
+        // the access profile; false for a bad entry
+        bool open(size_t entry, EmbedFSReader &reader);
+
+        // Sum of listed file sizes; hidden aliases share their target's bytes
+        size_t totalBytes() const;
+
+        // See EmbedFSFS::setDefaultDocuments()/setSearchPaths()/setPreload(); applied right away
+        void setDefaultDocuments(const char *const documents[], size_t count);
+        void setSearchPaths(const char *const roots[], size_t count, size_t cache_slots = 0);
+        void setPreload(const char *const patterns[], size_t count, PreloadMemory memory = PreloadAny);
+        size_t preloadedBytes() const { return preloadBytes_; }
+
+        // Flash and RAM of the current mount (zeros when unmounted) and live decoders. Walks
+        // the entries once, with a temporary array of their data extents.
+        EmbedFSFootprint footprint() const;
+        // "<key> <bytes>" lines (flash.data ... ram.total, then the open counts) for a
+        // diagnostics console; returns the number of lines written
+        static size_t writeFootprint(const EmbedFSFootprint &footprint, WriteCallback write, void *context);
+        // RAM held by a list() result
+        static size_t listingBytes(const std::vector<DirEntry> &entries);
+
+        void startProfile(size_t max_entries);
+        void stopProfile() { profiling_ = false; }
+        // "<count> <path>" lines; returns the number of lines written
+        size_t writeProfile(WriteCallback write, void *context) const;
+
+    protected:
+        // Called before a mount is replaced or dropped, while its names are still valid;
+        // BasicEmbedFSCore stops and clears its lookup here
+        virtual void unmounting() {}
+
+        // Directory key is the prefix of a listed entry
+        bool isDirectory(const char *key, size_t len) const;
+        bool hasMimeIds() const { return mimeIds_ != nullptr; }
+        // Generator MIME id of entry when there is one, else the extension lookup of path
+        uint8_t mimeIdOf(size_t entry, const char *path) const;
+
+    private:
+        // Resolved file contents. For sparse entries data points at the extent table
+        // (see EmbedFSImage.h) and size is the logical size; for deflated archive entries
+        // data points at the raw deflate stream described by coding.
+        struct EntryData
+        {
+            const uint8_t *data;
+            size_t size;
+            bool sparse;
+            bool ram;        // preloaded copy or device index rather than image data
+            uint32_t offset; // blob offset; device images read it through the block cache
+            const EmbedFSArchive::Coding *coding;
+        };
+        struct TocCursor;
+        struct SearchRoot;
+
+        EmbedFSCoreBase(const EmbedFSCoreBase &) = delete;
+        EmbedFSCoreBase &operator=(const EmbedFSCoreBase &) = delete;
+
+        void mountArrays(const char *const *names, const uint8_t *const *data, const size_t *sizes, size_t count, size_t listed);
+        void mountImage(const EmbedFSImage &image);
+        bool mountArchive(std::unique_ptr<EmbedFSArchive> archive);
+        const char *nameAt(size_t i) const;
+        const char *decodeName(size_t rank) const;
+        EntryData entryAt(size_t index) const;
+        EntryData flashEntryAt(size_t index) const;
+        void openEntry(const EntryData &entry, EmbedFSReader &reader) const;
+        void clearPreload();
+        void clearSearchPaths();
+        size_t searchSlot(size_t slot) const { return searchSlots16_.empty() ? searchSlots32_[slot] : searchSlots16_[slot]; }
+        bool relativeNameIs(size_t entry, const SearchRoot &root, const char *key, size_t len) const;
+        void recordAccess(size_t i);
+
+        const char *const *names_;
+        const uint8_t *const *data_;
+        const size_t *sizes_;
+        size_t count_;
+        // Entries at or after listedCount_ (hidden aliases) resolve by path but are
+        // left out of directory listings
+        size_t listedCount_;
+        // Packed image (toc_ != nullptr); data_/sizes_ are unused then
+        const uint8_t *blob_;
+        const uint8_t *toc_;
+        const uint32_t *tocSkip_;
+        size_t skipInterval_;
+        const uint8_t *mimeIds_; // per-entry EmbedFSMime ids, or nullptr
+        const uint32_t *contentHashes_; // sorted {hash high, hash low, entry} triples, or nullptr
+        size_t contentHashCount_;
+        const char *const *tagNames_; // sorted, or nullptr
+        const uint32_t *tagStarts_;
+        const uint32_t *tagEntries_;
+        size_t tagCount_;
+        // Front-coded names (nameDict_ != nullptr, names_ is nullptr then); nameAt() decodes
+        // into nameBuf_ and continues from the last decoded name when walking forward
+        const uint8_t *nameDict_;
+        const uint32_t *nameBlocks_;
+        size_t nameBlockSize_;
+        const uint8_t *nameRanks_;
+        const uint8_t *nameEntries_;
+        uint64_t nameDigest_;
+        mutable std::string nameBuf_;
+        mutable size_t nameRank_; // position decoded into nameBuf_, or npos
+        mutable const uint8_t *nameNext_;
+        // Device images: the index lives in these RAM copies, file data behind cache_
+        std::shared_ptr<std::vector<uint8_t>> deviceIndex_; // names, TOC, MIME ids; shared with inline readers
+        std::vector<const char *> deviceNames_;
+        std::vector<uint32_t> deviceSkip_;
+        std::shared_ptr<EmbedFSBlockCache> cache_;
+        uint32_t blobOffset_;
+        // Archives mounted in place: the index behind names_/data_/sizes_
+        std::unique_ptr<EmbedFSArchive> archive_;
+
+        struct DefaultDocument
+        {
+            std::string dir; // normalized directory path ("" for the root)
+            size_t entry;
+            size_t rank; // position in the configured document list
+        };
+        std::vector<DefaultDocument> defaultDocs_; // sorted by dir
+
+        struct SearchRoot
+        {
+            std::string dir; // normalized root ("" for "/")
+            size_t first;    // first slot of its table in searchSlots16_/searchSlots32_
+            size_t slots;    // power of two
+        };
+        struct SearchCacheSlot
+        {
+            uint32_t hash; // nameHash() of the relative name
+            uint32_t entry; // entry + 1, 0 when empty
+            uint32_t root;
+        };
+        // One open-addressing table per root of entry + 1 keyed by the name relative to the
+        // root, back to back; 16-bit slots while entry numbers fit
+        std::vector<SearchRoot> searchRoots_;
+        std::vector<uint16_t> searchSlots16_;
+        std::vector<uint32_t> searchSlots32_;
+        mutable std::vector<SearchCacheSlot> searchCache_; // direct-mapped by hash, or empty
+
+        struct Preloaded
+        {
+            size_t entry;
+            size_t offset; // into preloadBlock_
+            size_t size;
+        };
+        std::shared_ptr<uint8_t> preloadBlock_; // shared with the readers of preloaded files
+        size_t preloadBytes_;
+        std::vector<Preloaded> preloaded_; // sorted by entry
+
+        struct ProfileEntry
+        {
+            uint32_t entry;
+            uint32_t count;
+        };
+        bool profiling_;
+        size_t profileLimit_;
+        std::vector<ProfileEntry> profile_; // first-access order
+    };
+
+    // Lookup policies. find() returns the first entry named key (see pathKey()) or npos;
+    // setIndex() picks when the policy's index is built (see IndexMode), the policy what it
+    // is. cancel() stops a background build; reset() also drops the index and the mode.
+
+    // Name scan only: no RAM and no index code. setIndex() is accepted and ignored.
+    class EmbedFSLinearLookup
+    {
+    public:
+        size_t find(const EmbedFSCoreBase &core, const char *key, size_t len) const { return core.scan(key, len); }
+        void setIndex(const EmbedFSCoreBase &, IndexMode, const uint8_t *, size_t) {}
+        bool ready() const { return false; }
+        size_t write(const EmbedFSCoreBase &, EmbedFSCoreBase::WriteCallback, void *) const { return 0; }
+        void cancel() {}
+        void reset() {}
+        size_t memoryUsage() const { return 0; }
+    };
+
+    // Entry numbers ordered by name and bisected: 2 bytes per file (4 past 65534 entries)
+    // and O(log n) name compares. IndexBackground builds like IndexLazy; the order is cheap
+    // to rebuild and not persisted (write() returns 0, a saved blob is ignored).
+    class EmbedFSSortedLookup
+    {
+    public:
+        EmbedFSSortedLookup() : mode_(IndexOff), ready_(false) {}
+        size_t find(const EmbedFSCoreBase &core, const char *key, size_t len) const;
+        void setIndex(const EmbedFSCoreBase &core, IndexMode mode, const uint8_t *saved, size_t saved_size);
+        bool ready() const { return ready_; }
+        size_t write(const EmbedFSCoreBase &, EmbedFSCoreBase::WriteCallback, void *) const { return 0; }
+        void cancel() {}
+        void reset();
+        // Heap bytes of the order, once built
+        size_t memoryUsage() const { return ready_ ? order16_.capacity() * 2 + order32_.capacity() * 4 : 0; }
+
+    private:
+        void build(const EmbedFSCoreBase &core) const;
+        template <typename Slot>
+        void fill(const EmbedFSCoreBase &core, std::vector<Slot> &order) const;
+        template <typename Slot>
+        size_t search(const EmbedFSCoreBase &core, const std::vector<Slot> &order, const char *key, size_t len) const;
+
+        IndexMode mode_;
+        mutable bool ready_;
+        mutable std::vector<uint16_t> order16_; // entry numbers while they fit
+        mutable std::vector<uint32_t> order32_;
+    };
+
+    // Open-addressing hash table of the names (2-4 bytes per slot, about 3-6 bytes per
+    // file), built on the other core with IndexBackground and persisted by write()
+    class EmbedFSHashLookup
+    {
+    public:
+        EmbedFSHashLookup();
+        ~EmbedFSHashLookup();
+        size_t find(const EmbedFSCoreBase &core, const char *key, size_t len) const;
+        void setIndex(const EmbedFSCoreBase &core, IndexMode mode, const uint8_t *saved, size_t saved_size);
+        bool ready() const { return state_ == Ready; }
+        size_t write(const EmbedFSCoreBase &core, EmbedFSCoreBase::WriteCallback write, void *context) const;
+        void cancel();
+        void reset();
+        // Heap bytes of the table, once built (a background build is not counted until ready)
+        size_t memoryUsage() const { return ready() ? index16_.capacity() * 2 + index32_.capacity() * 4 : 0; }
+
+    private:
+        enum State : uint8_t
+        {
+            Idle,
+            Building,
+            Ready
+        };
+#if defined(EMBEDFS_INDEX_TASK) || defined(EMBEDFS_INDEX_THREAD)
+        typedef std::atomic<uint8_t> Flag; // shared with the background builder
+#else
+        typedef uint8_t Flag;
+#endif
+
+        EmbedFSHashLookup(const EmbedFSHashLookup &) = delete;
+        EmbedFSHashLookup &operator=(const EmbedFSHashLookup &) = delete;
+
+        static uint64_t nameTableKey(const EmbedFSCoreBase &core);
+        bool adopt(const EmbedFSCoreBase &core, const uint8_t *blob, size_t size);
+        static void task(void *arg);
+        void build(const EmbedFSCoreBase &core) const;
+        template <typename Slot>
+        bool fill(const EmbedFSCoreBase &core, std::vector<Slot> &table, size_t slots) const;
+        template <typename Slot>
+        size_t probe(const EmbedFSCoreBase &core, const std::vector<Slot> &table, const char *key, size_t len) const;
+
+        IndexMode mode_;
+        mutable Flag state_;
+        Flag cancel_;
+        const EmbedFSCoreBase *core_; // mount being indexed in the background
+        mutable std::vector<uint16_t> index16_; // set once state_ is Ready
+        mutable std::vector<uint32_t> index32_;
+#if defined(EMBEDFS_INDEX_THREAD)
+        std::thread thread_;
+#endif
+    };
+
+    // Engine with the path lookup of policy Lookup (EmbedFSLinearLookup,
+    // EmbedFSSortedLookup or EmbedFSHashLookup); only the chosen lookup is compiled in
+    template <class Lookup>
+    class BasicEmbedFSCore : public EmbedFSCoreBase
+    {
+    public:
+        typedef Lookup LookupPolicy;
+
+        ~BasicEmbedFSCore() { end(); }
+
+        // Entry of the file at path, or npos
+        size_t find(const char *path) const
+        {
+            if (!path || !mounted())
+                return npos;
+            size_t len;
+            const char *key = pathKey(path, len);
+            return hasNameDictionary() ? findName(key, len) : lookup_.find(*this, key, len);
+        }
+        // A file or a directory (the root always exists)
+        bool exists(const char *path) const
+        {
+            if (!path || !mounted())
+                return false;
+            size_t len;
+            const char *key = pathKey(path, len);
+            return len == 0 || (hasNameDictionary() ? findName(key, len) : lookup_.find(*this, key, len)) != npos ||
+                   isDirectory(key, len);
+        }
+        // Generator-precomputed MIME id of the file or default document at path when the
+        // image carries one (aliases keep their target's type), else the extension lookup
+        uint8_t mimeId(const char *path) const
+        {
+            size_t entry = npos;
+            if (path && hasMimeIds())
+            {
+                entry = find(path);
+                if (entry == npos)
+                    entry = findDefaultDocument(path);
+            }
+            return mimeIdOf(entry, path);
+        }
+
+        // Build the path index now (IndexEager), at the first lookup (IndexLazy) or on the
+        // other core (IndexBackground); IndexOff keeps the scan. A saved index (writeIndex())
+        // for the same names is adopted instead, whatever the mode, by lookups that persist.
+        // Ignored for front-coded names, which need no index.
+        void setIndex(IndexMode mode, const uint8_t *saved = nullptr, size_t saved_size = 0)
+        {
+            if (!hasNameDictionary())
+                lookup_.setIndex(*this, mode, saved, saved_size);
+        }
+        bool indexReady() const { return lookup_.ready(); }
+        // Serialize the index, building it first when idle; 0 while a background build runs
+        // or when the lookup does not persist (and with front-coded names)
+        size_t writeIndex(WriteCallback write, void *context) const
+        {
+            return hasNameDictionary() ? 0 : lookup_.write(*this, write, context);
+        }
+
+        // EmbedFSCoreBase::footprint() plus the lookup's index and the engine object
+        EmbedFSFootprint footprint() const
+        {
+            EmbedFSFootprint fp = EmbedFSCoreBase::footprint();
+            fp.lookup = lookup_.memoryUsage();
+            fp.engine += sizeof(*this) - sizeof(EmbedFSCoreBase);
+            return fp;
+        }
+
+    protected:
+        void unmounting() override { lookup_.reset(); }
+
+    private:
+        Lookup lookup_;
+    };
+
+    typedef BasicEmbedFSCore<EmbedFSDefaultPolicy::Lookup> EmbedFSCore;
+
+} // namespace fs
+
+#endif // EMBEDFS_CORE_H
@@ -0,0 +1,103 @@
+/*
+  EmbedFSImage.h
+
+  Descriptor for packed EmbedFS images generated by tools/embed_assets.py --format packed.
+  - All file bytes live in one blob; per-file offsets and sizes are stored in a compact
+    varint table of contents (TOC) instead of a pointer array and a size_t array.
+  - A sampled skip table gives random access into the TOC.
+
+  This header has no Arduino dependency so generated headers can include it anywhere.
+*/
+
+#ifndef EMBEDFS_IMAGE_H
+#define EMBEDFS_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bumped whenever the TOC encoding, the device header or EmbedFSImage changes incompatibly.
+#define EMBEDFS_IMAGE_VERSION 3
+
+// TOC entry layout (one per file, in file order):
+//   varint head = (size << EMBEDFS_TOC_FLAG_BITS) | flags
+//   [zigzag varint delta]  when EMBEDFS_TOC_GAP is set
+//   [varint stored size]   when EMBEDFS_TOC_SPARSE is set
+//   [size bytes]           when EMBEDFS_TOC_INLINE is set (file data stored in the TOC)
+// The data offset of a blob entry is the end of the previous blob entry (offset + stored
+// size) plus the optional delta, so contiguous files cost nothing beyond their size varint.
+// Inline entries take no blob space and do not move that running offset.
+//
+// Sparse entries keep only their non-zero extents. size is the logical size; the blob
+// holds varint extent count, then {varint hole before extent, varint extent length} per
+// extent, then the extent bytes back to back. Everything outside the extents reads as 0.
+#define EMBEDFS_TOC_FLAG_BITS 3
+#define EMBEDFS_TOC_GAP 0x01
+#define EMBEDFS_TOC_INLINE 0x02
+#define EMBEDFS_TOC_SPARSE 0x04
+
+// Content hashes (tools/embed_assets.py --content-hash): one triple per stored file (aliases
+// are left out), the first 64 bits of the SHA-256 of its bytes as two words, most significant
+// first, and its entry number; sorted by hash, then entry.
+
+// Tags (manifest "tags"): names sorted by strcmp(); tag t holds the ascending entry numbers
+// tagEntries[tagStarts[t]] up to tagEntries[tagStarts[t + 1]], so tagStarts has tagCount + 1
+// words.
+
+// Front-coded names (tools/embed_assets.py --name-blocks): the normalized names (no leading
+// '/') sorted by strcmp() in blocks of nameBlockSize. nameBlocks[b] is the offset in nameDict
+// of block b, plus one final word with the dictionary size. A block stores its first name in
+// full, NUL-terminated, then per name a varint count of leading bytes shared with the
+// previous name and the rest, NUL-terminated. nameRanks (entry to sorted position) and
+// nameEntries (position to entry) are 16-bit little-endian byte pairs, both nullptr when
+// entries are already in name order. fileNames is nullptr then.
+
+// Name digest: 64-bit FNV-1a (offset basis xor fileCount) over every name as stored, each
+// with its NUL terminator, in entry order. It keys a saved path index (writeIndex()), so
+// begin() can adopt one without hashing the names; 0 when not recorded (front-coded names).
+
+// Device image (tools/embed_assets.py --emit image) for EmbedFSFS::begin(EmbedFSBlockDevice&),
+// all integers little-endian:
+//   uint32 header[EMBEDFS_DEVICE_HEADER_WORDS] = {magic, version, fileCount, listedCount,
+//       skipInterval, namesSize, tocSize, skipWords, mimeSize, mimeTable, blobOffset, blobSize,
+//       nameDigest low word, nameDigest high word}
+//   names (NUL-terminated, entry order), TOC, skip table words, MIME ids (mimeSize bytes),
+//   then the blob at blobOffset. Sparse entries are not used in device images.
+#define EMBEDFS_DEVICE_MAGIC 0x49534645u // "EFSI"
+#define EMBEDFS_DEVICE_HEADER_WORDS 14
+
+namespace fs
+{
+
+    struct EmbedFSImage
+    {
+        uint32_t version;              // EMBEDFS_IMAGE_VERSION
+        uint32_t fileCount;            // number of entries
+        const char *const *fileNames;  // file paths, same as the plain assets_file_names, or
+                                       // nullptr with front-coded names
+        const uint8_t *data;           // concatenated file bytes (PROGMEM/const)
+        const uint8_t *toc;            // varint-encoded entries
+        const uint32_t *tocSkip;       // {toc offset, data offset} pairs every skipInterval entries
+        uint32_t skipInterval;         // entries per skip table slot (> 0)
+        uint32_t listedCount;          // entries [0, listedCount) appear in directory listings; 0 = all
+        const uint8_t *mimeIds;        // per-entry EmbedFSMime id (optional)
+        uint32_t mimeTable;            // EmbedFSMime::tableHash() of the generator's table; the
+                                       // ids are ignored when it differs from the firmware's
+        const char *const *preload;    // paths copied to RAM at begin() (optional, see setPreload)
+        uint32_t preloadCount;
+        const uint32_t *contentHashes; // sorted content hash triples (optional, see openByHash)
+        uint32_t contentHashCount;
+        const char *const *tagNames;   // tag names (optional, see EmbedFSFS::openTagged)
+        const uint32_t *tagStarts;     // first tagEntries index of each tag, then the total
+        const uint32_t *tagEntries;    // entry numbers of every tag, back to back
+        uint32_t tagCount;
+        const uint8_t *nameDict;       // front-coded names (optional, replaces fileNames)
+        const uint32_t *nameBlocks;    // dictionary offset of each block, then its size
+        uint32_t nameBlockSize;        // names per block
+        const uint8_t *nameRanks;      // entry -> sorted position, or nullptr
+        const uint8_t *nameEntries;    // sorted position -> entry, or nullptr
+        uint64_t nameDigest;           // digest of fileNames (see above), or 0
+    };
+
+} // namespace fs
+
+#endif // EMBEDFS_IMAGE_H
@@ -0,0 +1,321 @@
+/*
+  EmbedFSInflate.cpp
+  Resumable raw deflate decoder for deflated ZIP entries.
+*/
+
+#include "EmbedFSInflate.h"
+#include "EmbedFSPolicy.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace fs;
+
+static const size_t MAX_WINDOW = 32768;
+
+static EmbedFSCounter liveBytes_(0);
+
+static const uint16_t LENGTH_BASE[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                         31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DIST_BASE[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                       193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+// Order of code length code lengths in a dynamic block header
+static const uint8_t CLEN_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+EmbedFSInflate::EmbedFSInflate()
+    : src_(nullptr), srcSize_(0), srcPos_(0), bitBuf_(0), bitCount_(0), window_(nullptr), windowMask_(0), total_(0),
+      outSize_(0), state_(Done), last_(false), storedLeft_(0), matchLeft_(0), matchDistance_(0)
+{
+    lencode_.symbol = lenSymbol_;
+    distcode_.symbol = distSymbol_;
+    liveBytes_ += sizeof(EmbedFSInflate);
+}
+
+EmbedFSInflate::~EmbedFSInflate()
+{
+    liveBytes_ -= sizeof(EmbedFSInflate) + (window_ ? windowMask_ + 1 : 0);
+    free(window_);
+}
+
+size_t EmbedFSInflate::liveBytes() { return liveBytes_; }
+
+void EmbedFSInflate::begin(const uint8_t *src, size_t size, size_t out_size)
+{
+    src_ = src;
+    srcSize_ = src ? size : 0;
+    srcPos_ = 0;
+    bitBuf_ = 0;
+    bitCount_ = 0;
+    total_ = 0;
+    outSize_ = out_size;
+    state_ = Header;
+    last_ = false;
+    storedLeft_ = 0;
+    matchLeft_ = 0;
+    matchDistance_ = 0;
+}
+
+// Next need bits (LSB first); marks the stream failed when the input runs out
+int EmbedFSInflate::bits(int need)
+{
+    while (bitCount_ < need)
+    {
+        if (srcPos_ >= srcSize_)
+        {
+            state_ = Failed;
+            return 0;
+        }
+        bitBuf_ |= static_cast<uint32_t>(src_[srcPos_++]) << bitCount_;
+        bitCount_ += 8;
+    }
+    int value = static_cast<int>(bitBuf_ & ((1u << need) - 1));
+    bitBuf_ >>= need;
+    bitCount_ -= need;
+    return value;
+}
+
+// Decode one symbol, one code bit at a time; -1 on an invalid code or end of input
+int EmbedFSInflate::decode(const Huffman &h)
+{
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int len = 1; len < 16; ++len)
+    {
+        code |= bits(1);
+        if (state_ == Failed)
+            return -1;
+        int count = h.count[len];
+        if (code - count < first)
+            return h.symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+// Canonical code from code lengths; false when over-subscribed (incomplete codes are
+// allowed, their unused codes fail in decode())
+bool EmbedFSInflate::build(Huffman &h, const uint8_t *lengths, int n)
+{
+    memset(h.count, 0, sizeof(h.count));
+    for (int i = 0; i < n; ++i)
+        ++h.count[lengths[i]];
+    if (h.count[0] == n)
+        return true;
+    int left = 1;
+    for (int len = 1; len < 16; ++len)
+    {
+        left <<= 1;
+        left -= h.count[len];
+        if (left < 0)
+            return false;
+    }
+    int16_t offs[16];
+    offs[1] = 0;
+    for (int len = 1; len < 15; ++len)
+        offs[len + 1] = offs[len] + h.count[len];
+    for (int i = 0; i < n; ++i)
+    {
+        if (lengths[i])
+            h.symbol[offs[lengths[i]]++] = static_cast<int16_t>(i);
+    }
+    return true;
+}
+
+void EmbedFSInflate::fixedTables()
+{
+    uint8_t lengths[288 + 30];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+    memset(lengths + 288, 5, 30);
+    build(lencode_, lengths, 288);
+    build(distcode_, lengths + 288, 30);
+}
+
+bool EmbedFSInflate::dynamicTables()
+{
+    int nlen = bits(5) + 257;
+    int ndist = bits(5) + 1;
+    int ncode = bits(4) + 4;
+    if (state_ == Failed || nlen > 286 || ndist > 30)
+        return false;
+    uint8_t lengths[286 + 30];
+    memset(lengths, 0, 19);
+    for (int i = 0; i < ncode; ++i)
+        lengths[CLEN_ORDER[i]] = static_cast<uint8_t>(bits(3));
+    if (state_ == Failed || !build(lencode_, lengths, 19))
+        return false;
+    for (int i = 0; i < nlen + ndist;)
+    {
+        int symbol = decode(lencode_);
+        if (symbol < 0)
+            return false;
+        if (symbol < 16)
+        {
+            lengths[i++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+        uint8_t repeat = 0;
+        int times;
+        if (symbol == 16)
+        {
+            if (i == 0)
+                return false;
+            repeat = lengths[i - 1];
+            times = 3 + bits(2);
+        }
+        else if (symbol == 17)
+        {
+            times = 3 + bits(3);
+        }
+        else
+        {
+            times = 11 + bits(7);
+        }
+        if (state_ == Failed || i + times > nlen + ndist)
+            return false;
+        while (times--)
+            lengths[i++] = repeat;
+    }
+    // the end-of-block code must be present
+    return lengths[256] != 0 && build(lencode_, lengths, nlen) && build(distcode_, lengths + nlen, ndist);
+}
+
+bool EmbedFSInflate::startBlock()
+{
+    if (last_)
+    {
+        state_ = Done;
+        return true;
+    }
+    last_ = bits(1) != 0;
+    int type = bits(2);
+    if (state_ == Failed)
+        return false;
+    if (type == 0)
+    {
+        // stored: skip to a byte boundary; bits() never holds a whole unread byte
+        bitBuf_ = 0;
+        bitCount_ = 0;
+        if (srcSize_ - srcPos_ < 4)
+            return false;
+        const uint8_t *p = src_ + srcPos_;
+        uint16_t len = static_cast<uint16_t>(p[0] | (p[1] << 8));
+        uint16_t nlen = static_cast<uint16_t>(p[2] | (p[3] << 8));
+        if (len != static_cast<uint16_t>(~nlen))
+            return false;
+        srcPos_ += 4;
+        storedLeft_ = len;
+        state_ = Stored;
+        return true;
+    }
+    if (type == 1)
+        fixedTables();
+    else if (type != 2 || !dynamicTables())
+        return false;
+    state_ = Codes;
+    return true;
+}
+
+size_t EmbedFSInflate::read(uint8_t *out, size_t size)
+{
+    if (!window_ && state_ != Done && state_ != Failed)
+    {
+        size_t want = outSize_ < MAX_WINDOW ? outSize_ : MAX_WINDOW;
+        size_t windowSize = 1;
+        while (windowSize < want)
+            windowSize <<= 1;
+        window_ = static_cast<uint8_t *>(malloc(windowSize));
+        if (!window_)
+        {
+            state_ = Failed;
+            return 0;
+        }
+        windowMask_ = windowSize - 1;
+        liveBytes_ += windowSize;
+    }
+    size_t done = 0;
+    while (done < size)
+    {
+        if (matchLeft_)
+        {
+            for (; matchLeft_ && done < size; --matchLeft_)
+                put(out, done, window_[(total_ - matchDistance_) & windowMask_]);
+            continue;
+        }
+        if (state_ == Header)
+        {
+            if (!startBlock())
+                state_ = Failed;
+        }
+        else if (state_ == Stored)
+        {
+            if (storedLeft_ == 0)
+            {
+                state_ = Header;
+                continue;
+            }
+            if (srcPos_ >= srcSize_)
+            {
+                state_ = Failed;
+                break;
+            }
+            size_t n = size - done;
+            if (n > storedLeft_)
+                n = storedLeft_;
+            if (n > srcSize_ - srcPos_)
+                n = srcSize_ - srcPos_;
+            for (size_t i = 0; i < n; ++i)
+                put(out, done, src_[srcPos_ + i]);
+            srcPos_ += n;
+            storedLeft_ -= n;
+        }
+        else if (state_ == Codes)
+        {
+            int symbol = decode(lencode_);
+            if (symbol < 0 || symbol > 285)
+            {
+                state_ = Failed;
+            }
+            else if (symbol < 256)
+            {
+                put(out, done, static_cast<uint8_t>(symbol));
+            }
+            else if (symbol == 256)
+            {
+                state_ = Header;
+            }
+            else
+            {
+                symbol -= 257;
+                size_t length = LENGTH_BASE[symbol] + bits(LENGTH_EXTRA[symbol]);
+                int distSymbol = decode(distcode_);
+                if (distSymbol < 0 || distSymbol > 29)
+                {
+                    state_ = Failed;
+                    break;
+                }
+                size_t distance = DIST_BASE[distSymbol] + bits(DIST_EXTRA[distSymbol]);
+                if (state_ == Failed || distance > total_ || distance > windowMask_ + 1)
+                {
+                    state_ = Failed;
+                    break;
+                }
+                matchLeft_ = length;
+                matchDistance_ = distance;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    return done;
+}
@@ -0,0 +1,94 @@
+/*
+  EmbedFSInflate.h
+
+  Streaming decoder for raw deflate streams (RFC 1951) held in addressable memory.
+  - Used for deflated entries of ZIP archives mounted with EmbedFSFS::beginZip()
+  - Output is produced in caller-sized pieces; only the back-reference window (32 KB, or
+    the inflated size when smaller) is allocated, on the first read
+  - Canonical Huffman decoding bit by bit, in the style of zlib's puff: small tables and
+    no per-stream setup beyond the block headers
+*/
+
+#ifndef EMBEDFS_INFLATE_H
+#define EMBEDFS_INFLATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace fs
+{
+
+    class EmbedFSInflate
+    {
+    public:
+        EmbedFSInflate();
+        ~EmbedFSInflate();
+
+        // Start decoding src (size bytes) from the beginning. out_size is the inflated size
+        // and bounds the window allocation.
+        void begin(const uint8_t *src, size_t size, size_t out_size);
+
+        // Inflate up to size bytes into out; fewer at the end of the stream or on error
+        size_t read(uint8_t *out, size_t size);
+
+        // Bytes produced since begin()
+        size_t produced() const { return total_; }
+        bool failed() const { return state_ == Failed; }
+
+        // RAM held by every live decoder in the program, windows included
+        static size_t liveBytes();
+
+    private:
+        enum State
+        {
+            Header,
+            Stored,
+            Codes,
+            Done,
+            Failed
+        };
+
+        struct Huffman
+        {
+            int16_t count[16]; // codes per length
+            int16_t *symbol;   // symbols ordered by code
+        };
+
+        EmbedFSInflate(const EmbedFSInflate &) = delete;
+        EmbedFSInflate &operator=(const EmbedFSInflate &) = delete;
+
+        int bits(int need);
+        int decode(const Huffman &h);
+        bool build(Huffman &h, const uint8_t *lengths, int n);
+        bool startBlock();
+        bool dynamicTables();
+        void fixedTables();
+        void put(uint8_t *out, size_t &done, uint8_t b)
+        {
+            out[done++] = b;
+            window_[total_++ & windowMask_] = b;
+        }
+
+        const uint8_t *src_;
+        size_t srcSize_;
+        size_t srcPos_;
+        uint32_t bitBuf_;
+        int bitCount_;
+        uint8_t *window_;
+        size_t windowMask_;
+        size_t total_;
+        size_t outSize_;
+        State state_;
+        bool last_;            // current block is the final one
+        size_t storedLeft_;    // bytes left in a stored block
+        size_t matchLeft_;     // bytes left in the pending back-reference
+        size_t matchDistance_;
+        int16_t lenSymbol_[288];
+        int16_t distSymbol_[30];
+        Huffman lencode_;
+        Huffman distcode_;
+    };
+
+} // namespace fs
+
+#endif // EMBEDFS_INFLATE_H
@@ -0,0 +1,66 @@
+/*
+  EmbedFSMime.cpp
+  Perfect-hash extension lookup over the tables in embedfs_mime_table.h.
+*/
+
+#include "EmbedFSMime.h"
+
+#include <string.h>
+
+#include "embedfs_mime_table.h"
+
+using namespace fs;
+
+// FNV-1a with a seeded offset basis; must match fnv1a() in tools/gen_mime_table.py
+static uint32_t mimeHash(const char *ext, size_t len, uint32_t seed)
+{
+    uint32_t h = 0x811C9DC5u ^ (seed * 0x01000193u);
+    for (size_t i = 0; i < len; ++i)
+    {
+        h ^= static_cast<uint8_t>(ext[i]);
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+uint32_t EmbedFSMime::tableHash() { return EMBEDFS_MIME_TABLE_HASH; }
+
+uint8_t EmbedFSMime::idFromPath(const char *path)
+{
+    if (!path)
+        return 0;
+    const char *dot = nullptr;
+    for (const char *p = path; *p; ++p)
+    {
+        if (*p == '/')
+            dot = nullptr;
+        else if (*p == '.')
+            dot = p;
+    }
+    if (!dot)
+        return 0;
+    char ext[EMBEDFS_MIME_MAX_EXTENSION + 1];
+    size_t len = 0;
+    for (const char *p = dot + 1; *p; ++p)
+    {
+        if (len == EMBEDFS_MIME_MAX_EXTENSION)
+            return 0;
+        char c = *p;
+        ext[len++] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+    if (len == 0)
+        return 0;
+    ext[len] = '\0';
+
+    uint32_t bucket = mimeHash(ext, len, 0) % EMBEDFS_MIME_BUCKETS;
+    uint32_t slot = mimeHash(ext, len, kMimeSeeds[bucket]) & ((1u << EMBEDFS_MIME_TABLE_BITS) - 1);
+    uint8_t index = kMimeSlots[slot];
+    if (index == 0 || strcmp(kMimeExtensions[index - 1], ext) != 0)
+        return 0;
+    return kMimeExtensionIds[index - 1];
+}
+
+const char *EmbedFSMime::type(uint8_t id)
+{
+    return kMimeTypes[id <= EMBEDFS_MIME_TYPE_COUNT ? id : 0];
+}
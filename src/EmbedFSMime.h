@@ -0,0 +1,38 @@
+/*
+  EmbedFSMime.h
+
+  Extension to content-type resolution for servers built on EmbedFS.
+  - About 200 common extensions in a perfect hash generated by tools/gen_mime_table.py
+  - A lookup is one hash of the extension, one table load and one confirming compare,
+    instead of a chain of strcmp/endsWith calls per request
+  - MIME ids are stable per table and can be precomputed per file by tools/embed_assets.py;
+    images record tableHash() so ids from another table fall back to the extension
+*/
+
+#ifndef EMBEDFS_MIME_H
+#define EMBEDFS_MIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace fs
+{
+
+    class EmbedFSMime
+    {
+    public:
+        // MIME id for the extension of path (case-insensitive); 0 when unknown
+        static uint8_t idFromPath(const char *path);
+
+        // Content type for a MIME id; "application/octet-stream" for 0 or unknown ids
+        static const char *type(uint8_t id);
+
+        static const char *typeFromPath(const char *path) { return type(idFromPath(path)); }
+
+        // Hash of the id -> content type assignment of this table
+        static uint32_t tableHash();
+    };
+
+} // namespace fs
+
+#endif // EMBEDFS_MIME_H
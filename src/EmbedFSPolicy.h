@@ -0,0 +1,341 @@
+/*
+  EmbedFSPolicy.h
+
+  Compile-time strategies behind EmbedFSCore and EmbedFSFS, bundled into per-target presets.
+  - Lookup (per core, BasicEmbedFSCore<Lookup> in EmbedFSCore.h): EmbedFSLinearLookup,
+    EmbedFSSortedLookup, EmbedFSHashLookup
+  - Storage (per build, used by EmbedFSCore.cpp): how image bytes are read.
+    EmbedFSDirectStorage dereferences them (memory-mapped flash, RAM), EmbedFSProgmemStorage
+    uses pgm_read_* (AVR), EmbedFSBackendStorage reads through one out-of-line function
+    (seen by the EMBEDFS_CACHE_SIM flash model)
+  - Handles (per build, used by EmbedFS.cpp): where the objects behind File live.
+    EmbedFSHeapHandles allocates each one, EmbedFSPoolHandles<N> reuses N slots taken from
+    the heap once, EmbedFSStaticHandles<N> keeps N slots in static storage; idleBytes<T>()
+    reports the free slots to footprint()
+
+  Strategies that are not selected are never instantiated (templates) or are dropped by the
+  linker (-ffunction-sections/--gc-sections, the Arduino default), so they cost no flash.
+  EmbedFSDefaultPolicy is the preset for the target; build with
+  -DEMBEDFS_POLICY=fs::EmbedFSHostPolicy (or any EmbedFSPolicy<...>) to override it.
+*/
+
+#ifndef EMBEDFS_POLICY_H
+#define EMBEDFS_POLICY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVR__)
+#include <pgmspace.h>
+// Files open at once with the AVR preset (directories have as many slots of their own);
+// every slot is reserved in static RAM. Build with -DEMBEDFS_AVR_HANDLES=N to change it.
+#ifndef EMBEDFS_AVR_HANDLES
+#define EMBEDFS_AVR_HANDLES 2
+#endif
+#endif
+#if defined(ESP_PLATFORM) || !defined(ARDUINO)
+#define EMBEDFS_ATOMICS 1 // handles may be opened from several tasks/threads
+#include <atomic>
+#endif
+
+namespace fs
+{
+
+    // Process-wide tally of live objects (handles, listings, decoders) for footprint()
+#if defined(EMBEDFS_ATOMICS)
+    typedef std::atomic<size_t> EmbedFSCounter;
+#else
+    typedef size_t EmbedFSCounter;
+#endif
+
+    // ---------------- Storage ----------------
+
+    // Image bytes are plain memory: readers of flash entries take the inline path
+    struct EmbedFSDirectStorage
+    {
+        static const bool direct = true;
+        static uint8_t byte(const uint8_t *p) { return *p; }
+        static uint32_t dword(const uint32_t *p) { return *p; }
+        static void copy(uint8_t *dst, const uint8_t *src, size_t n) { memcpy(dst, src, n); }
+    };
+
+#if defined(__AVR__)
+    // Image bytes live in PROGMEM and are read with pgm_read_*/memcpy_P
+    struct EmbedFSProgmemStorage
+    {
+        static const bool direct = false;
+        static uint8_t byte(const uint8_t *p) { return pgm_read_byte(p); }
+        static uint32_t dword(const uint32_t *p) { return pgm_read_dword(p); }
+        static void copy(uint8_t *dst, const uint8_t *src, size_t n) { memcpy_P(dst, src, n); }
+    };
+#endif
+
+    // Every image read goes through copy(), defined in EmbedFSCore.cpp; with EMBEDFS_CACHE_SIM
+    // it feeds the attached EmbedFSCacheSim
+    struct EmbedFSBackendStorage
+    {
+        static const bool direct = false;
+        static uint8_t byte(const uint8_t *p)
+        {
+            uint8_t b;
+            copy(&b, p, 1);
+            return b;
+        }
+        static uint32_t dword(const uint32_t *p)
+        {
+            uint32_t v;
+            copy(reinterpret_cast<uint8_t *>(&v), reinterpret_cast<const uint8_t *>(p), sizeof(v));
+            return v;
+        }
+        static void copy(uint8_t *dst, const uint8_t *src, size_t n);
+    };
+
+    // ---------------- Handles ----------------
+
+    // One slot of storage handed to std::allocate_shared(), which places the File object and
+    // its reference counts there; the slot size is checked against them at compile time
+    template <class T, size_t SlotBytes>
+    struct EmbedFSSlotAllocator
+    {
+        typedef T value_type;
+        template <class U>
+        struct rebind
+        {
+            typedef EmbedFSSlotAllocator<U, SlotBytes> other;
+        };
+
+        EmbedFSSlotAllocator(void *s, void (*r)(void *)) : slot(s), release(r) {}
+        template <class U>
+        EmbedFSSlotAllocator(const EmbedFSSlotAllocator<U, SlotBytes> &other) : slot(other.slot), release(other.release) {}
+
+        T *allocate(size_t)
+        {
+            static_assert(sizeof(T) <= SlotBytes, "EmbedFS handle slot too small");
+            return static_cast<T *>(slot);
+        }
+        void deallocate(T *p, size_t) { release(p); }
+        template <class U>
+        bool operator==(const EmbedFSSlotAllocator<U, SlotBytes> &other) const { return slot == other.slot; }
+        template <class U>
+        bool operator!=(const EmbedFSSlotAllocator<U, SlotBytes> &other) const { return slot != other.slot; }
+
+        void *slot;
+        void (*release)(void *);
+    };
+
+    // N slots for handles of type T, shared by every EmbedFSFS in the program; Static keeps
+    // them in .bss, otherwise they are allocated on the first acquire()
+    template <class T, size_t N, bool Static>
+    class EmbedFSHandleSlots
+    {
+    public:
+        static_assert(N >= 1 && N <= 32, "EmbedFS handle pools hold 1 to 32 slots");
+        // T plus a shared_ptr control block, rounded up to the strictest alignment
+        static const size_t SlotBytes = (sizeof(T) + 8 * sizeof(void *) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+        typedef EmbedFSSlotAllocator<T, SlotBytes> Allocator;
+
+        // A free slot, or nullptr when all N are in use (or the pool could not be allocated)
+        static void *acquire()
+        {
+            uint8_t *base = storage();
+            if (!base)
+                return nullptr;
+#if defined(EMBEDFS_ATOMICS)
+            uint32_t used = used_.load();
+            for (;;)
+            {
+                size_t i = firstFree(used);
+                if (i == N)
+                    return nullptr;
+                if (used_.compare_exchange_weak(used, used | (1u << i)))
+                    return base + i * SlotBytes;
+            }
+#else
+            size_t i = firstFree(used_);
+            if (i == N)
+                return nullptr;
+            used_ |= 1u << i;
+            return base + i * SlotBytes;
+#endif
+        }
+
+        static void release(void *slot)
+        {
+            size_t i = static_cast<size_t>(static_cast<uint8_t *>(slot) - storage()) / SlotBytes;
+            used_ &= ~(1u << i);
+        }
+
+        // RAM of the slots not holding a handle (static storage always counts, a pool once
+        // allocated); handles in use are counted by their owner
+        static size_t idleBytes()
+        {
+            if (!Static && !allocated())
+                return 0;
+            uint32_t used = used_;
+            size_t idle = N;
+            for (size_t i = 0; i < N; ++i)
+                idle -= (used >> i) & 1;
+            return idle * SlotBytes;
+        }
+
+    private:
+        static size_t firstFree(uint32_t used)
+        {
+            size_t i = 0;
+            while (i < N && (used & (1u << i)))
+                ++i;
+            return i;
+        }
+
+        static uint8_t *storage() { return storage(std::integral_constant<bool, Static>()); }
+        static uint8_t *storage(std::true_type)
+        {
+            alignas(max_align_t) static uint8_t slots[N * SlotBytes];
+            return slots;
+        }
+        static uint8_t *storage(std::false_type)
+        {
+            // never freed: the pool lives as long as the program, like the static one
+            static uint8_t *slots = allocate();
+            return slots;
+        }
+        static uint8_t *allocate()
+        {
+            uint8_t *slots = static_cast<uint8_t *>(malloc(N * SlotBytes));
+            allocated() = slots != nullptr;
+            return slots;
+        }
+        static EmbedFSCounter &allocated()
+        {
+            static EmbedFSCounter flag(0);
+            return flag;
+        }
+
+#if defined(EMBEDFS_ATOMICS)
+        static std::atomic<uint32_t> used_;
+#else
+        static uint32_t used_;
+#endif
+    };
+
+#if defined(EMBEDFS_ATOMICS)
+    template <class T, size_t N, bool Static>
+    std::atomic<uint32_t> EmbedFSHandleSlots<T, N, Static>::used_(0);
+#else
+    template <class T, size_t N, bool Static>
+    uint32_t EmbedFSHandleSlots<T, N, Static>::used_ = 0;
+#endif
+
+    // One heap allocation per open File
+    struct EmbedFSHeapHandles
+    {
+        template <class T, class... Args>
+        static std::shared_ptr<T> make(Args &&...args)
+        {
+            return std::make_shared<T>(std::forward<Args>(args)...);
+        }
+        template <class T>
+        static size_t idleBytes()
+        {
+            return 0;
+        }
+    };
+
+    // N slots allocated on the first open and reused; opens beyond N fall back to the heap
+    template <size_t N>
+    struct EmbedFSPoolHandles
+    {
+        template <class T, class... Args>
+        static std::shared_ptr<T> make(Args &&...args)
+        {
+            typedef EmbedFSHandleSlots<T, N, false> Slots;
+            void *slot = Slots::acquire();
+            if (!slot)
+                return std::make_shared<T>(std::forward<Args>(args)...);
+            return std::allocate_shared<T>(typename Slots::Allocator(slot, &Slots::release), std::forward<Args>(args)...);
+        }
+        // RAM of the idle slots for T, 0 until the first open
+        template <class T>
+        static size_t idleBytes()
+        {
+            return EmbedFSHandleSlots<T, N, false>::idleBytes();
+        }
+    };
+
+    // N slots in static storage; opens beyond N fail (an invalid File), like the
+    // maxOpenFiles limit of SPIFFS/LittleFS
+    template <size_t N>
+    struct EmbedFSStaticHandles
+    {
+        static_assert(N > 0, "EmbedFSStaticHandles needs at least one slot");
+
+        template <class T, class... Args>
+        static std::shared_ptr<T> make(Args &&...args)
+        {
+            typedef EmbedFSHandleSlots<T, N, true> Slots;
+            void *slot = Slots::acquire();
+            if (!slot)
+                return std::shared_ptr<T>();
+            return std::allocate_shared<T>(typename Slots::Allocator(slot, &Slots::release), std::forward<Args>(args)...);
+        }
+        template <class T>
+        static size_t idleBytes()
+        {
+            return EmbedFSHandleSlots<T, N, true>::idleBytes();
+        }
+    };
+
+    // ---------------- Presets ----------------
+
+    class EmbedFSLinearLookup;
+    class EmbedFSSortedLookup;
+    class EmbedFSHashLookup;
+
+    template <class LookupPolicy, class StoragePolicy, class HandlePolicy>
+    struct EmbedFSPolicy
+    {
+        typedef LookupPolicy Lookup;
+        typedef StoragePolicy Storage;
+        typedef HandlePolicy Handles;
+    };
+
+#if defined(__AVR__)
+    // PROGMEM images and a few KB of RAM: name scan, pgm_read_*, EMBEDFS_AVR_HANDLES static
+    // handles
+    typedef EmbedFSPolicy<EmbedFSLinearLookup, EmbedFSProgmemStorage, EmbedFSStaticHandles<EMBEDFS_AVR_HANDLES>>
+        EmbedFSAvrPolicy;
+#endif
+    // Memory-mapped flash, a second core for background indexing: hash index, inline reads,
+    // a pool sized like LittleFS's default maxOpenFiles
+    typedef EmbedFSPolicy<EmbedFSHashLookup, EmbedFSDirectStorage, EmbedFSPoolHandles<10>> EmbedFSEsp32Policy;
+    // Other Arduino cores (RP2040, SAMD, STM32, ...): mapped flash, tighter RAM: the sorted
+    // index costs 2 bytes per file against 3-6 for the hash
+    typedef EmbedFSPolicy<EmbedFSSortedLookup, EmbedFSDirectStorage, EmbedFSPoolHandles<4>> EmbedFSMcuPolicy;
+    // Desktop builds (tests, tools, benchmarks)
+    typedef EmbedFSPolicy<EmbedFSHashLookup, EmbedFSDirectStorage, EmbedFSHeapHandles> EmbedFSHostPolicy;
+    // Desktop builds feeding the flash cache model
+    typedef EmbedFSPolicy<EmbedFSHashLookup, EmbedFSBackendStorage, EmbedFSHeapHandles> EmbedFSCacheSimPolicy;
+
+#if defined(EMBEDFS_POLICY)
+    typedef EMBEDFS_POLICY EmbedFSDefaultPolicy;
+#elif defined(__AVR__)
+    typedef EmbedFSAvrPolicy EmbedFSDefaultPolicy;
+#elif defined(EMBEDFS_CACHE_SIM)
+    typedef EmbedFSCacheSimPolicy EmbedFSDefaultPolicy;
+#elif defined(ESP_PLATFORM)
+    typedef EmbedFSEsp32Policy EmbedFSDefaultPolicy;
+#elif defined(ARDUINO)
+    typedef EmbedFSMcuPolicy EmbedFSDefaultPolicy;
+#else
+    typedef EmbedFSHostPolicy EmbedFSDefaultPolicy;
+#endif
+
+} // namespace fs
+
+#endif // EMBEDFS_POLICY_H
@@ -0,0 +1,275 @@
+/* Auto-generated by tools/gen_mime_table.py - do not edit manually */
+#ifndef EMBEDFS_MIME_TABLE_H
+#define EMBEDFS_MIME_TABLE_H
+
+#define EMBEDFS_MIME_TABLE_BITS 9
+#define EMBEDFS_MIME_BUCKETS 128
+#define EMBEDFS_MIME_MAX_EXTENSION 15
+#define EMBEDFS_MIME_TYPE_COUNT 161
+// FNV-1a of the content types in id order, recorded in images next to their MIME ids
+#define EMBEDFS_MIME_TABLE_HASH 0xA29CA5EEu
+
+// Displacement seed per first-level bucket
+static const uint8_t kMimeSeeds[EMBEDFS_MIME_BUCKETS] = {
+    1, 2, 0, 0, 3, 1, 1, 0, 0, 2, 1, 1, 0, 3, 1, 2,
+    0, 0, 1, 1, 2, 1, 1, 1, 6, 1, 0, 1, 1, 0, 1, 4,
+    1, 1, 2, 5, 0, 1, 1, 1, 2, 2, 1, 1, 1, 1, 0, 1,
+    1, 1, 2, 1, 1, 1, 2, 0, 1, 1, 1, 1, 2, 0, 2, 1,
+    1, 1, 1, 2, 1, 1, 0, 1, 2, 2, 1, 1, 5, 1, 1, 1,
+    1, 1, 1, 1, 2, 3, 3, 2, 5, 0, 1, 1, 3, 1, 1, 1,
+    1, 1, 0, 1, 1, 1, 1, 1, 2, 1, 3, 2, 1, 6, 4, 5,
+    1, 1, 1, 1, 1, 1, 2, 5, 4, 2, 3, 1, 3, 3, 2, 1
+};
+
+// Hash slot -> extension index + 1 (0 = empty)
+static const uint8_t kMimeSlots[1 << EMBEDFS_MIME_TABLE_BITS] = {
+    140, 0, 3, 215, 0, 91, 118, 214, 56, 0, 0, 0, 0, 0, 0, 57,
+    77, 188, 103, 0, 0, 0, 86, 0, 0, 191, 49, 184, 0, 0, 80, 172,
+    178, 0, 68, 0, 132, 0, 26, 0, 0, 0, 0, 0, 63, 209, 0, 0,
+    46, 0, 0, 0, 0, 85, 216, 0, 0, 0, 58, 82, 0, 0, 0, 0,
+    122, 182, 0, 157, 0, 2, 13, 0, 218, 0, 149, 109, 0, 106, 0, 20,
+    100, 0, 147, 0, 0, 0, 0, 0, 131, 0, 161, 67, 213, 0, 0, 159,
+    0, 210, 145, 0, 75, 0, 133, 169, 0, 0, 0, 171, 0, 0, 208, 0,
+    0, 89, 96, 112, 0, 99, 0, 28, 98, 35, 0, 160, 32, 37, 0, 198,
+    48, 0, 87, 97, 0, 0, 0, 43, 0, 0, 92, 1, 0, 0, 0, 181,
+    130, 0, 0, 156, 74, 0, 113, 0, 164, 0, 0, 193, 0, 0, 0, 0,
+    115, 0, 45, 0, 18, 116, 143, 0, 65, 0, 0, 192, 205, 0, 0, 51,
+    142, 0, 0, 0, 0, 29, 0, 101, 141, 0, 0, 124, 0, 0, 0, 38,
+    94, 0, 0, 0, 8, 0, 33, 162, 70, 0, 0, 0, 0, 0, 202, 34,
+    10, 42, 108, 217, 0, 0, 0, 0, 0, 189, 120, 90, 0, 17, 0, 186,
+    0, 0, 0, 95, 0, 211, 183, 55, 0, 0, 174, 0, 0, 59, 117, 0,
+    11, 54, 154, 0, 0, 47, 136, 0, 0, 0, 0, 0, 15, 0, 0, 0,
+    0, 0, 0, 0, 0, 6, 7, 0, 0, 0, 0, 0, 0, 187, 0, 185,
+    146, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 166, 0, 0, 0, 150,
+    0, 0, 0, 0, 194, 5, 0, 125, 134, 71, 36, 129, 0, 196, 16, 0,
+    170, 0, 52, 173, 110, 0, 0, 0, 175, 0, 76, 84, 0, 0, 203, 0,
+    0, 195, 78, 0, 107, 0, 21, 0, 0, 0, 121, 0, 0, 0, 0, 153,
+    53, 0, 190, 0, 30, 123, 25, 127, 0, 137, 27, 0, 0, 0, 206, 0,
+    0, 0, 0, 0, 0, 138, 0, 111, 0, 62, 128, 39, 0, 148, 0, 41,
+    0, 0, 0, 0, 0, 0, 158, 0, 0, 0, 104, 0, 177, 0, 0, 0,
+    139, 0, 135, 0, 14, 0, 0, 0, 0, 66, 0, 0, 0, 0, 69, 0,
+    0, 0, 199, 179, 0, 24, 50, 0, 73, 0, 31, 22, 0, 197, 0, 83,
+    0, 0, 0, 0, 0, 207, 88, 0, 0, 0, 19, 168, 0, 0, 0, 0,
+    144, 64, 0, 0, 200, 0, 81, 4, 23, 44, 0, 0, 0, 72, 0, 0,
+    0, 119, 0, 0, 0, 0, 0, 176, 0, 0, 105, 0, 12, 0, 61, 0,
+    114, 0, 0, 212, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 93,
+    102, 0, 0, 201, 0, 165, 0, 0, 0, 40, 0, 167, 151, 155, 152, 126,
+    0, 0, 0, 180, 204, 0, 0, 0, 163, 0, 0, 0, 60, 79, 0, 0
+};
+
+static const char *const kMimeExtensions[] = {
+    "html", "htm", "shtml", "xhtml", "css", "js", "mjs", "cjs",
+    "json", "map", "jsonld", "webmanifest", "txt", "text", "log", "ini",
+    "conf", "cfg", "md", "markdown", "csv", "tsv", "xml", "xsl",
+    "xsd", "dtd", "rss", "atom", "yaml", "yml", "toml", "ics",
+    "vcf", "vtt", "srt", "rtf", "appcache", "manifest", "htc", "sgml",
+    "c", "h", "cpp", "hpp", "ino", "py", "sh", "lua",
+    "php", "wasm", "ts", "tsx", "jsx", "vue", "scss", "sass",
+    "less", "coffee", "tmpl", "mustache", "hbs", "png", "apng", "jpg",
+    "jpeg", "jpe", "jfif", "pjpeg", "pjp", "gif", "bmp", "dib",
+    "ico", "cur", "svg", "svgz", "webp", "avif", "heic", "heif",
+    "tif", "tiff", "jxl", "jp2", "psd", "tga", "pbm", "pgm",
+    "ppm", "pnm", "xbm", "xpm", "wbmp", "dds", "ktx", "ktx2",
+    "exr", "hdr", "qoi", "mp3", "mpga", "wav", "wave", "ogg",
+    "oga", "opus", "flac", "aac", "m4a", "mid", "midi", "weba",
+    "aif", "aiff", "au", "snd", "amr", "caf", "wma", "mka",
+    "pcm", "raw", "mp4", "m4v", "mpg", "mpeg", "webm", "ogv",
+    "mov", "avi", "mkv", "wmv", "flv", "3gp", "3g2", "m3u8",
+    "m3u", "mpd", "h264", "mjpg", "mjpeg", "woff", "woff2", "ttf",
+    "otf", "ttc", "eot", "pfb", "bdf", "pcf", "pdf", "ps",
+    "eps", "doc", "docx", "xls", "xlsx", "ppt", "pptx", "odt",
+    "ods", "odp", "epub", "tex", "zip", "gz", "tgz", "tar",
+    "bz2", "xz", "7z", "rar", "zst", "br", "lz4", "jar",
+    "apk", "bin", "dat", "img", "iso", "exe", "dll", "elf",
+    "hex", "dfu", "uf2", "deb", "rpm", "dmg", "swf", "pem",
+    "crt", "cer", "der", "key", "p12", "pfx", "csr", "sig",
+    "asc", "cbor", "msgpack", "pb", "proto", "sqlite", "db", "gltf",
+    "glb", "obj", "stl", "3mf", "usdz", "geojson", "gpx", "kml",
+    "kmz", "torrent"
+};
+
+// Extension index -> MIME id
+static const uint8_t kMimeExtensionIds[] = {
+    131, 131, 131, 63, 129, 132, 132, 132, 9, 9, 10, 11, 135, 135, 135, 135,
+    135, 135, 134, 134, 130, 137, 64, 64, 64, 65, 19, 1, 66, 66, 21, 127,
+    139, 140, 58, 20, 126, 126, 142, 136, 141, 141, 141, 141, 141, 145, 56, 144,
+    49, 39, 151, 138, 133, 135, 147, 146, 129, 128, 135, 135, 143, 102, 91, 98,
+    98, 98, 98, 98, 98, 94, 93, 93, 112, 112, 104, 104, 110, 92, 95, 96,
+    105, 105, 99, 97, 107, 117, 114, 115, 116, 113, 118, 119, 109, 106, 100, 101,
+    111, 108, 103, 77, 77, 80, 80, 78, 78, 79, 74, 70, 76, 75, 75, 81,
+    71, 71, 73, 73, 72, 82, 85, 83, 69, 0, 152, 152, 153, 153, 156, 154,
+    155, 161, 158, 160, 157, 148, 149, 23, 84, 3, 150, 159, 159, 89, 90, 88,
+    87, 86, 29, 48, 46, 47, 14, 18, 18, 13, 36, 28, 35, 30, 34, 33,
+    32, 31, 4, 60, 67, 7, 7, 59, 44, 62, 40, 37, 68, 43, 51, 8,
+    22, 0, 0, 0, 50, 27, 27, 45, 135, 0, 0, 24, 55, 41, 57, 52,
+    61, 17, 61, 0, 53, 53, 16, 15, 15, 2, 12, 54, 135, 38, 0, 121,
+    122, 123, 124, 120, 125, 5, 6, 25, 26, 42
+};
+
+// MIME id -> content type (id 0 is unknown)
+static const char *const kMimeTypes[EMBEDFS_MIME_TYPE_COUNT + 1] = {
+    "application/octet-stream",
+    "application/atom+xml",
+    "application/cbor",
+    "application/dash+xml",
+    "application/epub+zip",
+    "application/geo+json",
+    "application/gpx+xml",
+    "application/gzip",
+    "application/java-archive",
+    "application/json",
+    "application/ld+json",
+    "application/manifest+json",
+    "application/msgpack",
+    "application/msword",
+    "application/pdf",
+    "application/pgp-signature",
+    "application/pkcs10",
+    "application/pkix-cert",
+    "application/postscript",
+    "application/rss+xml",
+    "application/rtf",
+    "application/toml",
+    "application/vnd.android.package-archive",
+    "application/vnd.apple.mpegurl",
+    "application/vnd.debian.binary-package",
+    "application/vnd.google-earth.kml+xml",
+    "application/vnd.google-earth.kmz",
+    "application/vnd.microsoft.portable-executable",
+    "application/vnd.ms-excel",
+    "application/vnd.ms-fontobject",
+    "application/vnd.ms-powerpoint",
+    "application/vnd.oasis.opendocument.presentation",
+    "application/vnd.oasis.opendocument.spreadsheet",
+    "application/vnd.oasis.opendocument.text",
+    "application/vnd.openxmlformats-officedocument.presentationml.presentation",
+    "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
+    "application/vnd.openxmlformats-officedocument.wordprocessingml.document",
+    "application/vnd.rar",
+    "application/vnd.sqlite3",
+    "application/wasm",
+    "application/x-7z-compressed",
+    "application/x-apple-diskimage",
+    "application/x-bittorrent",
+    "application/x-brotli",
+    "application/x-bzip2",
+    "application/x-elf",
+    "application/x-font-bdf",
+    "application/x-font-pcf",
+    "application/x-font-type1",
+    "application/x-httpd-php",
+    "application/x-iso9660-image",
+    "application/x-lz4",
+    "application/x-pem-file",
+    "application/x-pkcs12",
+    "application/x-protobuf",
+    "application/x-rpm",
+    "application/x-sh",
+    "application/x-shockwave-flash",
+    "application/x-subrip",
+    "application/x-tar",
+    "application/x-tex",
+    "application/x-x509-ca-cert",
+    "application/x-xz",
+    "application/xhtml+xml",
+    "application/xml",
+    "application/xml-dtd",
+    "application/yaml",
+    "application/zip",
+    "application/zstd",
+    "audio/L16",
+    "audio/aac",
+    "audio/aiff",
+    "audio/amr",
+    "audio/basic",
+    "audio/flac",
+    "audio/midi",
+    "audio/mp4",
+    "audio/mpeg",
+    "audio/ogg",
+    "audio/opus",
+    "audio/wav",
+    "audio/webm",
+    "audio/x-caf",
+    "audio/x-matroska",
+    "audio/x-mpegurl",
+    "audio/x-ms-wma",
+    "font/collection",
+    "font/otf",
+    "font/ttf",
+    "font/woff",
+    "font/woff2",
+    "image/apng",
+    "image/avif",
+    "image/bmp",
+    "image/gif",
+    "image/heic",
+    "image/heif",
+    "image/jp2",
+    "image/jpeg",
+    "image/jxl",
+    "image/ktx",
+    "image/ktx2",
+    "image/png",
+    "image/qoi",
+    "image/svg+xml",
+    "image/tiff",
+    "image/vnd-ms.dds",
+    "image/vnd.adobe.photoshop",
+    "image/vnd.radiance",
+    "image/vnd.wap.wbmp",
+    "image/webp",
+    "image/x-exr",
+    "image/x-icon",
+    "image/x-portable-anymap",
+    "image/x-portable-bitmap",
+    "image/x-portable-graymap",
+    "image/x-portable-pixmap",
+    "image/x-tga",
+    "image/x-xbitmap",
+    "image/x-xpixmap",
+    "model/3mf",
+    "model/gltf+json",
+    "model/gltf-binary",
+    "model/obj",
+    "model/stl",
+    "model/vnd.usdz+zip",
+    "text/cache-manifest",
+    "text/calendar",
+    "text/coffeescript",
+    "text/css",
+    "text/csv",
+    "text/html",
+    "text/javascript",
+    "text/jsx",
+    "text/markdown",
+    "text/plain",
+    "text/sgml",
+    "text/tab-separated-values",
+    "text/tsx",
+    "text/vcard",
+    "text/vtt",
+    "text/x-c",
+    "text/x-component",
+    "text/x-handlebars-template",
+    "text/x-lua",
+    "text/x-python",
+    "text/x-sass",
+    "text/x-scss",
+    "video/3gpp",
+    "video/3gpp2",
+    "video/h264",
+    "video/mp2t",
+    "video/mp4",
+    "video/mpeg",
+    "video/ogg",
+    "video/quicktime",
+    "video/webm",
+    "video/x-flv",
+    "video/x-matroska",
+    "video/x-motion-jpeg",
+    "video/x-ms-wmv",
+    "video/x-msvideo"
+};
+
+#endif // EMBEDFS_MIME_TABLE_H
@@ -0,0 +1,139 @@
+"""Build-time transformation stage for tools/embed_assets.py.
+
+Manifest "transforms" is a list of rules; the first rule whose "match" glob matches an
+asset path (relative to the assets folder, "*" also crosses "/") applies its "steps" in
+order. A step is either a built-in name or {"cmd": [...]} running an external tool that
+reads the asset on stdin and writes the result to stdout.
+
+Results are cached in a directory keyed by a hash of the input bytes and the steps.
+"""
+
+from __future__ import annotations
+
+import fnmatch
+import gzip
+import hashlib
+import json
+import os
+import pathlib
+import re
+import subprocess
+import sys
+
+
+# Punctuation that never needs whitespace around it
+_CSS_TIGHT = {"{", "}", ";", ","}
+
+
+def _minify_css(data: bytes) -> bytes:
+    text = data.decode("utf-8")
+    # one piece per token outside strings, a string literal as one piece
+    out: list[str] = []
+    i = 0
+    while i < len(text):
+        ch = text[i]
+        if ch in "\"'":
+            end = i + 1
+            while end < len(text) and text[end] != ch:
+                end += 2 if text[end] == "\\" else 1
+            out.append(text[i : end + 1])
+            i = end + 1
+        elif text.startswith("/*", i):
+            end = text.find("*/", i + 2)
+            i = len(text) if end < 0 else end + 2
+        elif ch.isspace():
+            while i < len(text) and text[i].isspace():
+                i += 1
+            if out and out[-1] != " " and out[-1] not in _CSS_TIGHT:
+                out.append(" ")
+        elif ch in _CSS_TIGHT:
+            if out and out[-1] == " ":
+                out.pop()
+            if ch == "}" and out and out[-1] == ";":
+                out.pop()
+            out.append(ch)
+            i += 1
+        else:
+            out.append(ch)
+            i += 1
+    if out and out[-1] == " ":
+        out.pop()
+    return "".join(out).encode("utf-8")
+
+
+_HTML_RAW = re.compile(r"(<(pre|textarea|script|style)\b.*?</\2\s*>)", re.IGNORECASE | re.DOTALL)
+
+
+def _minify_html(data: bytes) -> bytes:
+    text = data.decode("utf-8")
+    parts = _HTML_RAW.split(text)
+    out: list[str] = []
+    # split() yields text, raw block, tag name, text, ...
+    for index in range(0, len(parts), 3):
+        chunk = re.sub(r"<!--(?!\[if).*?-->", "", parts[index], flags=re.DOTALL)
+        out.append(re.sub(r"\s+", lambda m: "\n" if "\n" in m.group(0) else " ", chunk))
+        if index + 1 < len(parts):
+            out.append(parts[index + 1])
+    return "".join(out).strip().encode("utf-8")
+
+
+def _minify_xml(data: bytes) -> bytes:
+    text = re.sub(r"<!--.*?-->", "", data.decode("utf-8"), flags=re.DOTALL)
+    return re.sub(r">\s+<", "><", text).strip().encode("utf-8")
+
+
+def _minify_json(data: bytes) -> bytes:
+    value = json.loads(data.decode("utf-8"))
+    return json.dumps(value, separators=(",", ":"), ensure_ascii=False).encode("utf-8")
+
+
+BUILTINS = {
+    "minify-css": _minify_css,
+    "minify-html": _minify_html,
+    "minify-svg": _minify_xml,
+    "minify-xml": _minify_xml,
+    "minify-json": _minify_json,
+}
+
+
+def match_rule(rules: list[dict], rel_path: str) -> dict | None:
+    for rule in rules:
+        if fnmatch.fnmatchcase(rel_path, rule["match"]):
+            return rule
+    return None
+
+
+def _run_step(step: str | dict, data: bytes, name: str) -> bytes:
+    if isinstance(step, dict):
+        result = subprocess.run(step["cmd"], input=data, capture_output=True, check=False)
+        if result.returncode != 0:
+            sys.exit(f"{name}: {' '.join(step['cmd'])} failed: {result.stderr.decode(errors='replace')}")
+        return result.stdout
+    if step == "gzip":
+        return gzip.compress(data, compresslevel=9, mtime=0)
+    if step not in BUILTINS:
+        sys.exit(f"{name}: unknown transform step {step!r}")
+    return BUILTINS[step](data)
+
+
+def apply_rule(rule: dict, data: bytes, name: str, cache_dir: pathlib.Path | None) -> tuple[bytes, bool]:
+    """Run the rule's steps on data; return (result, cache hit)."""
+    steps = rule.get("steps", [])
+    key = hashlib.sha256(json.dumps(steps, sort_keys=True).encode("utf-8") + b"\0" + data).hexdigest()
+    cached = cache_dir / key if cache_dir else None
+    if cached and cached.is_file():
+        return cached.read_bytes(), True
+    for step in steps:
+        data = _run_step(step, data, name)
+    if cached:
+        # workers may finish the same key concurrently; publish complete files only
+        cache_dir.mkdir(parents=True, exist_ok=True)
+        partial = cached.with_name(f"{key}.{os.getpid()}.tmp")
+        partial.write_bytes(data)
+        os.replace(partial, cached)
+    return data, False
+
+
+def renamed_path(rule: dict, path: str) -> str:
+    """gzip steps serve the result under path + ".gz"."""
+    return path + ".gz" if "gzip" in rule.get("steps", []) else path
@@ -0,0 +1,1183 @@
+#!/usr/bin/env python3
+"""Convert an assets/ folder into a C header (assets_embed.h) for EmbedFS."""
+
+from __future__ import annotations
+
+import argparse
+import contextlib
+import fnmatch
+import functools
+import hashlib
+import json
+import os
+import pathlib
+import re
+import struct
+import sys
+import time
+from concurrent.futures import ProcessPoolExecutor, ThreadPoolExecutor
+from dataclasses import dataclass
+
+import asset_transforms
+from gen_mime_table import mime_id, table_hash
+
+
+@dataclass
+class Asset:
+    path: str  # embedded path, e.g. "/directory/1.txt"
+    source: pathlib.Path
+    symbol: str
+    data: bytes
+    alias_of: int | None = None  # index of the aliased asset (manifest "aliases")
+    mime_path: str = ""  # path that decides the MIME id (before a ".gz" rename)
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "assets",
+        nargs="?",
+        default="assets",
+        help="Assets directory to embed (default: assets).",
+    )
+    parser.add_argument(
+        "-o",
+        "--output",
+        help="Output header (default: assets_embed.h next to the assets directory).",
+    )
+    parser.add_argument(
+        "--manifest",
+        help="JSON manifest with generator options such as aliases (see README).",
+    )
+    parser.add_argument(
+        "--cache-dir",
+        help="Cache for manifest transform results (default: .embedfs-cache next to the assets directory).",
+    )
+    parser.add_argument(
+        "--no-cache",
+        action="store_true",
+        help="Run manifest transforms without reading or writing the cache.",
+    )
+    parser.add_argument(
+        "--format",
+        choices=("arrays", "packed"),
+        default="arrays",
+        help="arrays: one C array per file plus name/data/size tables (default). "
+        "packed: one data blob plus a varint table of contents.",
+    )
+    parser.add_argument(
+        "--profile",
+        help="Access profile written by EmbedFS.writeProfile(): profiled files come first in the "
+        "index (most opened first) and their data is laid out in first-access order.",
+    )
+    parser.add_argument(
+        "--profile-line",
+        type=int,
+        help="With --profile and --format packed or --emit asm: keep each profiled file of at most "
+        "this many bytes inside one flash cache line (default: 32, 0 disables; a power of two).",
+    )
+    parser.add_argument(
+        "--emit",
+        choices=("c", "asm", "image"),
+        default="c",
+        help="c: file bytes as C arrays in the header (default). "
+        "asm: bytes and tables in an assembler file (.S) that .incbin's a binary file; "
+        "the header keeps only extern declarations. "
+        "image: a binary packed image for external storage (EmbedFS.begin(device)).",
+    )
+    parser.add_argument(
+        "--section",
+        default=".rodata.embedfs",
+        help="asm: section for file bytes (default: .rodata.embedfs; use .progmem.data on AVR).",
+    )
+    parser.add_argument(
+        "--incbin-path",
+        help="asm: path written into .incbin (default: the .bin relative to the .S, found by the "
+        "assembler through the working directory or -I).",
+    )
+    parser.add_argument(
+        "--prefix",
+        default="assets",
+        help="Symbol prefix for generated arrays (default: assets).",
+    )
+    parser.add_argument(
+        "--align",
+        type=int,
+        default=1,
+        help="Packed format: data alignment of each file in the blob (default: 1; a power of two).",
+    )
+    parser.add_argument(
+        "--skip-interval",
+        type=int,
+        default=16,
+        help="Packed format: TOC entries per skip table slot (default: 16).",
+    )
+    parser.add_argument(
+        "--inline-max",
+        type=int,
+        default=16,
+        help="Packed format: store files up to this many bytes inside the TOC (default: 16, 0 disables).",
+    )
+    parser.add_argument(
+        "--sparse-min-run",
+        type=int,
+        default=0,
+        help="Packed format: store files as non-zero extents when they contain zero runs of "
+        "at least this many bytes and that saves space (default: 0, disabled).",
+    )
+    parser.add_argument(
+        "--content-hash",
+        action="store_true",
+        help="Packed format: add a table of file content hashes (first 64 bits of SHA-256, "
+        "sorted) for EmbedFS.openByHash() with fingerprinted URLs.",
+    )
+    parser.add_argument(
+        "--name-blocks",
+        type=int,
+        default=0,
+        help="Packed format: store names as a front-coded dictionary, sorted in blocks of this "
+        "many names, instead of assets_file_names; lookups search it without a RAM index "
+        "(default: 0, disabled).",
+    )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        type=int,
+        default=os.cpu_count() or 1,
+        help="Worker processes for reading, transforming and encoding files (default: all cores). "
+        "The output does not depend on this value.",
+    )
+    parser.add_argument(
+        "--pointer-size",
+        type=int,
+        default=4,
+        help="Target pointer/size_t width used for the index size report (default: 4).",
+    )
+    parser.add_argument(
+        "--report",
+        help="Write a JSON footprint report: flash by category (file data, padding, names, "
+        "index), the RAM of each runtime lookup index and one row per file.",
+    )
+    return parser.parse_args()
+
+
+def parallel_map(fn, items: list, jobs: int, threads: bool = False) -> list:
+    """map() over items on up to jobs workers; results keep input order so output is deterministic."""
+    if jobs <= 1 or len(items) < 2:
+        return [fn(item) for item in items]
+    if threads:
+        with ThreadPoolExecutor(max_workers=jobs) as pool:
+            return list(pool.map(fn, items))
+    with ProcessPoolExecutor(max_workers=min(jobs, len(items))) as pool:
+        return list(pool.map(fn, items, chunksize=max(1, len(items) // (jobs * 4))))
+
+
+class StageTimer:
+    """Wall-clock time per generator stage, printed at the end of a run."""
+
+    def __init__(self) -> None:
+        self.stages: list[tuple[str, float]] = []
+
+    @contextlib.contextmanager
+    def stage(self, name: str):
+        start = time.perf_counter()
+        try:
+            yield
+        finally:
+            self.stages.append((name, time.perf_counter() - start))
+
+    def report(self, jobs: int) -> str:
+        parts = ", ".join(f"{name} {seconds:.2f}s" for name, seconds in self.stages)
+        total = sum(seconds for _, seconds in self.stages)
+        return f"timing: {parts}, total {total:.2f}s ({jobs} jobs)"
+
+
+def _sanitize_symbol(name: str) -> str:
+    s = re.sub(r"[^A-Za-z0-9]+", "_", name).strip("_")
+    if re.match(r"^[0-9]", s):
+        s = "_" + s
+    return s
+
+
+def collect_assets(root: pathlib.Path, prefix: str, jobs: int) -> list[Asset]:
+    sources = sorted(p for p in root.rglob("*") if p.is_file())
+    contents = parallel_map(pathlib.Path.read_bytes, sources, jobs, threads=True)
+    assets: list[Asset] = []
+    for source, data in zip(sources, contents):
+        rel = source.relative_to(root).as_posix()
+        assets.append(
+            Asset(
+                path="/" + rel,
+                source=source,
+                symbol=_sanitize_symbol(f"{prefix}/{rel}"),
+                data=data,
+                mime_path="/" + rel,
+            )
+        )
+    return assets
+
+
+def _transform_job(job: tuple) -> tuple[bytes, bool]:
+    rule, data, name, cache_dir = job
+    return asset_transforms.apply_rule(rule, data, name, cache_dir)
+
+
+def transform_assets(
+    assets: list[Asset], manifest: dict, prefix: str, cache_dir: pathlib.Path | None, jobs: int
+) -> list[Asset]:
+    """Apply manifest transforms (minifiers, precompression) and return assets in path order."""
+    rules = manifest.get("transforms", [])
+    if not rules:
+        return assets
+    matched = [(a, asset_transforms.match_rule(rules, a.path[1:])) for a in assets]
+    matched = [(a, rule) for a, rule in matched if rule is not None]
+    results = parallel_map(_transform_job, [(rule, a.data, a.path[1:], cache_dir) for a, rule in matched], jobs)
+    before = after = hits = 0
+    for (asset, rule), (data, hit) in zip(matched, results):
+        before += len(asset.data)
+        after += len(data)
+        hits += hit
+        asset.data = data
+        asset.path = asset_transforms.renamed_path(rule, asset.path)
+        asset.symbol = _sanitize_symbol(f"{prefix}/{asset.path[1:]}")
+    print(f"transforms: {len(matched)} files, {before} -> {after} bytes ({hits} cached)")
+    return sorted(assets, key=lambda a: a.path)
+
+
+def load_manifest(path: str | None) -> dict:
+    if not path:
+        return {}
+    return json.loads(pathlib.Path(path).read_text(encoding="utf-8"))
+
+
+def add_aliases(assets: list[Asset], manifest: dict) -> int:
+    """Append manifest aliases to assets and return the number of listed entries.
+
+    Aliases reuse the bytes of their target. Unless "list_aliases" is true they are
+    placed after every listed entry so directory listings skip them.
+    """
+    by_path = {a.path: i for i, a in enumerate(assets)}
+    for i, a in enumerate(assets):
+        by_path.setdefault(a.mime_path, i)  # targets may name a file before its ".gz" rename
+    aliases = {"/" + k.strip("/"): "/" + v.strip("/") for k, v in manifest.get("aliases", {}).items()}
+    for path in sorted(aliases):
+        if path in by_path:
+            sys.exit(f"alias {path} collides with an existing file")
+        target = aliases[path]
+        seen = {path}
+        while target in aliases:  # alias of an alias
+            if target in seen:
+                sys.exit(f"alias loop at {path}")
+            seen.add(target)
+            target = aliases[target]
+        if target not in by_path:
+            sys.exit(f"alias {path} -> {aliases[path]}: target not found")
+        source = by_path[target]
+        by_path[path] = len(assets)
+        assets.append(
+            Asset(
+                path=path,
+                source=assets[source].source,
+                symbol=assets[source].symbol,
+                data=assets[source].data,
+                alias_of=source,
+            )
+        )
+    real = sum(1 for a in assets if a.alias_of is None)
+    return len(assets) if manifest.get("list_aliases", False) else real
+
+
+@dataclass
+class DataLayout:
+    order: list[int]  # stored (non-alias) asset indices in placement order
+    hot: set[int]  # profiled assets, kept inside one cache line when they fit
+    line: int = 0
+
+
+def default_layout(assets: list[Asset]) -> DataLayout:
+    return DataLayout([i for i, a in enumerate(assets) if a.alias_of is None], set())
+
+
+def load_profile(path: str) -> list[tuple[str, int]]:
+    """Parse "<count> <path>" lines (first-access order) from EmbedFS.writeProfile()."""
+    entries = []
+    for line in pathlib.Path(path).read_text(encoding="utf-8").splitlines():
+        fields = line.strip().split(" ", 1)
+        if len(fields) == 2 and fields[0].isdigit():
+            entries.append(("/" + fields[1].strip("/"), int(fields[0])))
+    return entries
+
+
+def apply_profile(
+    assets: list[Asset], listed: int, profile: list[tuple[str, int]], line: int
+) -> tuple[list[Asset], DataLayout]:
+    """Reorder entries and data by an access profile.
+
+    Entries: profiled files first, most opened first, so the runtime's linear name scan
+    and the names it touches stay at the front; hidden aliases stay after listed entries.
+    Data: profiled files in first-access order, so files used together share flash pages.
+    """
+    by_path = {a.path: i for i, a in enumerate(assets)}
+    for i, a in enumerate(assets):
+        by_path.setdefault(a.mime_path, i)
+    counts: dict[int, int] = {}
+    first: list[int] = []
+    missing = 0
+    for path, count in profile:
+        if path not in by_path:
+            missing += 1
+            continue
+        index = by_path[path]
+        if index not in counts:
+            first.append(index)
+        counts[index] = counts.get(index, 0) + count
+
+    def hot_first(indices: range) -> list[int]:
+        hot = sorted((i for i in indices if i in counts), key=lambda i: -counts[i])
+        return hot + [i for i in indices if i not in counts]
+
+    order = hot_first(range(listed)) + hot_first(range(listed, len(assets)))
+    new_index = {old: new for new, old in enumerate(order)}
+    reordered = []
+    for old in order:
+        asset = assets[old]
+        if asset.alias_of is not None:
+            asset.alias_of = new_index[asset.alias_of]
+        reordered.append(asset)
+
+    data_order: list[int] = []
+    for old in first:
+        source = new_index[old]
+        if reordered[source].alias_of is not None:
+            source = reordered[source].alias_of
+        if source not in data_order:
+            data_order.append(source)
+    hot = set(data_order)
+    data_order += [i for i, a in enumerate(reordered) if a.alias_of is None and i not in hot]
+    hot_bytes = sum(len(reordered[i].data) for i in hot)
+    print(f"profile: {len(hot)} hot files ({hot_bytes} bytes) placed first, {missing} profiled paths not found")
+    return reordered, DataLayout(data_order, hot, line)
+
+
+def name_order(assets: list[Asset], listed: int, layout: DataLayout) -> tuple[list[Asset], DataLayout]:
+    """Reorder entries by name, as the front-coded dictionary sorts them, so the image needs
+    no rank tables; hidden aliases stay after listed entries. The data layout is kept."""
+
+    def by_name(indices: range) -> list[int]:
+        return sorted(indices, key=lambda i: assets[i].path.strip("/").encode("utf-8"))
+
+    order = by_name(range(listed)) + by_name(range(listed, len(assets)))
+    new_index = {old: new for new, old in enumerate(order)}
+    reordered = []
+    for old in order:
+        asset = assets[old]
+        if asset.alias_of is not None:
+            asset.alias_of = new_index[asset.alias_of]
+        reordered.append(asset)
+    return reordered, DataLayout([new_index[i] for i in layout.order], {new_index[i] for i in layout.hot}, layout.line)
+
+
+def blob_alignment(align: int, layout: DataLayout) -> int:
+    """Alignment of the blob itself: place() positions files relative to its start."""
+    return max(4, align, layout.line if layout.hot else 0)
+
+
+def place(offset: int, size: int, align: int, hot: bool, line: int) -> int:
+    """First offset at or after offset that is aligned and, for hot files that fit,
+    does not straddle a cache line."""
+    start = offset + (-offset) % align
+    if hot and line and 0 < size <= line and start // line != (start + size - 1) // line:
+        start += (-start) % line
+        start += (-start) % align
+    return start
+
+
+def format_bytes(data: bytes, indent: str = "  ", per_line: int = 12) -> str:
+    lines = []
+    for i in range(0, len(data), per_line):
+        chunk = data[i : i + per_line]
+        lines.append(indent + ", ".join(f"0x{b:02X}" for b in chunk))
+    return ",\n".join(lines)
+
+
+FORMAT_CHUNK = 12 * 16384  # whole lines of format_bytes, so split output joins back identically
+
+
+def format_bytes_parallel(data: bytes, jobs: int) -> str:
+    chunks = [data[i : i + FORMAT_CHUNK] for i in range(0, len(data), FORMAT_CHUNK)]
+    return ",\n".join(parallel_map(format_bytes, chunks, jobs))
+
+
+def format_words(words: list[int], indent: str = "  ", per_line: int = 8) -> str:
+    lines = []
+    for i in range(0, len(words), per_line):
+        chunk = words[i : i + per_line]
+        lines.append(indent + ", ".join(f"0x{w:08X}" for w in chunk))
+    return ",\n".join(lines)
+
+
+def format_ids(values: list[int], indent: str = "  ", per_line: int = 16) -> str:
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ", ".join(str(v) for v in values[i : i + per_line]))
+    return ",\n".join(lines)
+
+
+def encode_varint(value: int) -> bytes:
+    out = bytearray()
+    while True:
+        b = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def zigzag(value: int) -> int:
+    return (value << 1) if value >= 0 else ((-value << 1) - 1)
+
+
+# Must match EmbedFSImage.h
+DEVICE_MAGIC = 0x49534645
+DEVICE_BLOB_ALIGN = 512  # blob starts on a sector so --align maps onto device blocks
+IMAGE_VERSION = 3
+DEVICE_HEADER_WORDS = 14
+TOC_FLAG_BITS = 3
+TOC_GAP = 0x01
+TOC_INLINE = 0x02
+TOC_SPARSE = 0x04
+
+
+def encode_sparse(data: bytes, min_run: int) -> bytes | None:
+    """Return the sparse extent encoding of data, or None when it would not be smaller."""
+    extents: list[tuple[int, int]] = []
+    start = 0
+    for run in re.finditer(b"\0{%d,}" % min_run, data):
+        if run.start() > start:
+            extents.append((start, run.start()))
+        start = run.end()
+    if start < len(data):
+        extents.append((start, len(data)))
+    out = bytearray(encode_varint(len(extents)))
+    prev_end = 0
+    for begin, end in extents:
+        out += encode_varint(begin - prev_end) + encode_varint(end - begin)
+        prev_end = end
+    for begin, end in extents:
+        out += data[begin:end]
+    return bytes(out) if len(out) < len(data) else None
+
+
+@dataclass
+class PackedImage:
+    blob: bytes
+    toc: bytes
+    skip: list[int]  # flattened {toc offset, data offset} pairs
+    placed: dict[int, tuple[int, int]]  # stored asset index -> (blob offset, stored size); others are inline
+
+
+def pack(
+    assets: list[Asset],
+    layout: DataLayout,
+    align: int,
+    skip_interval: int,
+    inline_max: int,
+    sparse_min_run: int,
+    jobs: int,
+) -> PackedImage:
+    # Encode sparse candidates up front on all workers; the layout pass below stays sequential.
+    sparse_forms: dict[int, bytes | None] = {}
+    if sparse_min_run > 0:
+        candidates = [i for i, a in enumerate(assets) if a.alias_of is None and len(a.data) > inline_max]
+        encode = functools.partial(encode_sparse, min_run=sparse_min_run)
+        sparse_forms = dict(zip(candidates, parallel_map(encode, [assets[i].data for i in candidates], jobs)))
+    # Blob layout follows layout.order; the TOC below follows entry order and uses
+    # offset deltas wherever the two differ.
+    blob = bytearray()
+    placed: dict[int, tuple[int, int, int]] = {}  # asset index -> (head, offset, stored size)
+    for index in layout.order:
+        asset = assets[index]
+        if len(asset.data) <= inline_max:
+            continue
+        head = len(asset.data) << TOC_FLAG_BITS
+        stored = asset.data
+        sparse = sparse_forms.get(index)
+        if sparse is not None:
+            head |= TOC_SPARSE
+            stored = sparse
+        offset = place(len(blob), len(stored), align, index in layout.hot, layout.line)
+        blob.extend(b"\0" * (offset - len(blob)))
+        blob.extend(stored)
+        placed[index] = (head, offset, len(stored))
+
+    toc = bytearray()
+    skip: list[int] = []
+    cursor = 0  # end of the previous blob entry, as tracked by the runtime decoder
+    for index, asset in enumerate(assets):
+        if index % skip_interval == 0:
+            skip.extend((len(toc), cursor))
+        source = index if asset.alias_of is None else asset.alias_of
+        if source not in placed:
+            toc += encode_varint((len(asset.data) << TOC_FLAG_BITS) | TOC_INLINE) + asset.data
+            continue
+        head, offset, stored_len = placed[source]
+        delta = offset - cursor
+        if delta:
+            toc += encode_varint(head | TOC_GAP) + encode_varint(zigzag(delta))
+        else:
+            toc += encode_varint(head)
+        if head & TOC_SPARSE:
+            toc += encode_varint(stored_len)
+        cursor = offset + stored_len
+    return PackedImage(bytes(blob), bytes(toc), skip, {i: (offset, size) for i, (_, offset, size) in placed.items()})
+
+
+def content_hashes(assets: list[Asset]) -> list[tuple[int, int]]:
+    """(hash, entry) for each stored file, sorted: the first 64 bits of the SHA-256 of its
+    bytes. Aliases are left out; they resolve to their target."""
+    stored = [(i, a) for i, a in enumerate(assets) if a.alias_of is None]
+    return sorted((int.from_bytes(hashlib.sha256(a.data).digest()[:8], "big"), i) for i, a in stored)
+
+
+def unique_hash_digits(hashes: list[tuple[int, int]]) -> int:
+    """Shortest hex prefix that tells every distinct content apart."""
+    distinct = sorted({h for h, _ in hashes})
+    digits = 1
+    for a, b in zip(distinct, distinct[1:]):
+        common = 0
+        while common < 16 and f"{a:016x}"[common] == f"{b:016x}"[common]:
+            common += 1
+        digits = max(digits, common + 1)
+    return digits
+
+
+def header_preamble(tool_mode: str, assets: list[Asset], include_image: bool) -> list[str]:
+    out = [f"// Auto-generated by tools/embed_assets.py ({tool_mode})", "// Index:"]
+    for asset in assets:
+        if asset.alias_of is None:
+            out.append(f"// - {asset.path} ({len(asset.data)} bytes)")
+        else:
+            out.append(f"// - {asset.path} -> {assets[asset.alias_of].path}")
+    out += ["", "#pragma once", "#include <cstddef>", "#include <cstdint>"]
+    if include_image:
+        out.append("#include <EmbedFSImage.h>")
+    out += ["", "#if defined(PROGMEM)", "#include <pgmspace.h>", "#endif", ""]
+    return out
+
+
+def count_constants(prefix: str, assets: list[Asset], listed: int) -> list[str]:
+    out = [f"constexpr size_t {prefix}_file_count = {len(assets)};"]
+    if listed != len(assets):
+        out.append(f"constexpr size_t {prefix}_file_listed_count = {listed};")
+    return out
+
+
+def preload_paths(assets: list[Asset], manifest: dict) -> list[str]:
+    """Entry paths matching manifest "preload" globs (copied to RAM at begin())."""
+    patterns = ["/" + p.lstrip("/") for p in manifest.get("preload", [])]
+    matched = [
+        a
+        for a in assets
+        if any(fnmatch.fnmatchcase(a.path, p) or fnmatch.fnmatchcase(a.mime_path or a.path, p) for p in patterns)
+    ]
+    if patterns:
+        print(f"preload: {len(matched)} files, {sum(len(a.data) for a in matched)} bytes")
+    return [a.path for a in matched]
+
+
+def tag_groups(assets: list[Asset], manifest: dict) -> list[tuple[str, list[int]]]:
+    """(tag, ascending entry numbers) per manifest "tags" entry, sorted by tag name: the
+    entries whose path matches one of the tag's globs, as for "preload"."""
+    groups = []
+    for tag, globs in sorted(manifest.get("tags", {}).items(), key=lambda t: t[0].encode("utf-8")):
+        if not tag:
+            sys.exit("manifest tags: empty tag name")
+        patterns = ["/" + p.lstrip("/") for p in ([globs] if isinstance(globs, str) else globs)]
+        entries = [
+            i
+            for i, a in enumerate(assets)
+            if any(fnmatch.fnmatchcase(a.path, p) or fnmatch.fnmatchcase(a.mime_path or a.path, p) for p in patterns)
+        ]
+        groups.append((tag, entries))
+    if groups:
+        print("tags: " + ", ".join(f"{tag} {len(entries)}" for tag, entries in groups) + " files")
+    return groups
+
+
+def tag_tables(prefix: str, tags: list[tuple[str, list[int]]]) -> list[str]:
+    if not tags:
+        return []
+    starts = [0]
+    for _, entries in tags:
+        starts.append(starts[-1] + len(entries))
+    out = [f"constexpr size_t {prefix}_tag_count = {len(tags)};"]
+    out.append(f"const char* const {prefix}_tag_names[{prefix}_tag_count] = {{")
+    out.append(",\n".join(f'  "{tag}"' for tag, _ in tags))
+    out.append("};")
+    out.append(f"const uint32_t {prefix}_tag_starts[] PROGMEM = {{")
+    out.append(format_ids(starts))
+    out.append("};")
+    out.append(f"const uint32_t {prefix}_tag_entries[] PROGMEM = {{")
+    out.append(format_ids([i for _, entries in tags for i in entries] or [0]))
+    out.append("};")
+    return out
+
+
+@dataclass
+class NameDict:
+    data: bytes  # blocks back to back
+    blocks: list[int]  # offset of each block in data, then len(data)
+    block_size: int
+    ranks: list[int] | None  # entry -> sorted position; None when entries are in name order
+    entries: list[int] | None  # sorted position -> entry
+
+    def flash(self) -> int:
+        return len(self.data) + 4 * len(self.blocks) + (4 * len(self.ranks) if self.ranks else 0)
+
+
+def front_code_names(assets: list[Asset], block_size: int) -> NameDict:
+    """Front-coded dictionary of the normalized names (see EmbedFSImage.h): sorted by bytes
+    as strcmp() orders them, the first name of each block in full, the others as a varint
+    count of bytes shared with the previous name and the rest."""
+    keys = [a.path.strip("/").encode("utf-8") for a in assets]
+    order = sorted(range(len(keys)), key=lambda i: keys[i])
+    data = bytearray()
+    blocks = []
+    for rank, entry in enumerate(order):
+        key = keys[entry]
+        if rank % block_size == 0:
+            blocks.append(len(data))
+            data += key + b"\0"
+            continue
+        previous = keys[order[rank - 1]]
+        shared = 0
+        while shared < min(len(key), len(previous)) and key[shared] == previous[shared]:
+            shared += 1
+        data += encode_varint(shared) + key[shared:] + b"\0"
+    blocks.append(len(data))
+    if order == list(range(len(keys))):
+        return NameDict(bytes(data), blocks, block_size, None, None)
+    ranks = [0] * len(order)
+    for rank, entry in enumerate(order):
+        ranks[entry] = rank
+    return NameDict(bytes(data), blocks, block_size, ranks, order)
+
+
+def name_dict_tables(prefix: str, names: NameDict) -> list[str]:
+    out = [f"const uint8_t {prefix}_name_dict[] PROGMEM = {{", format_bytes(names.data), "};"]
+    out += [f"const uint32_t {prefix}_name_blocks[] PROGMEM = {{", format_words(names.blocks), "};"]
+    if names.ranks:
+        for table, values in (("name_ranks", names.ranks), ("name_entries", names.entries)):
+            out.append(f"const uint8_t {prefix}_{table}[] PROGMEM = {{")
+            out.append(format_bytes(b"".join(struct.pack("<H", v) for v in values)))
+            out.append("};")
+    return out
+
+
+def preload_table(prefix: str, paths: list[str]) -> list[str]:
+    if not paths:
+        return []
+    out = [f"constexpr size_t {prefix}_preload_count = {len(paths)};"]
+    out.append(f"const char* const {prefix}_preload[{prefix}_preload_count] = {{")
+    out.append(",\n".join(f'  "{p}"' for p in paths))
+    out.append("};")
+    return out
+
+
+def name_digest(assets: list[Asset]) -> int:
+    """64-bit FNV-1a of the names as stored, matching EmbedFSHashLookup::nameTableKey()."""
+    h = 0xCBF29CE484222325 ^ len(assets)
+    for asset in assets:
+        for byte in asset.path.encode("utf-8") + b"\0":
+            h = ((h ^ byte) * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def names_table(prefix: str, assets: list[Asset], listed: int) -> list[str]:
+    out = count_constants(prefix, assets, listed)
+    out.append(f"const char* const {prefix}_file_names[{prefix}_file_count] = {{")
+    out.append(",\n".join(f'  "{a.path}"' for a in assets))
+    out.append("};")
+    return out
+
+
+def render_arrays(
+    prefix: str, assets: list[Asset], listed: int, layout: DataLayout, preload: list[str], jobs: int
+) -> str:
+    out = header_preamble("arrays", assets, include_image=False)
+    stored = [assets[i] for i in layout.order]
+    bodies = parallel_map(format_bytes, [a.data or b"\0" for a in stored], jobs)
+    for asset, body in zip(stored, bodies):
+        out.append(f"// {asset.path}")
+        out.append(f"alignas(4) const uint8_t {asset.symbol}[] PROGMEM = {{")
+        out.append(body)
+        out.append("};")
+        out.append(f"const size_t {asset.symbol}_len = {len(asset.data)};")
+        out.append("")
+    out += names_table(prefix, assets, listed)
+    out.append(f"const uint8_t* const {prefix}_file_data[{prefix}_file_count] = {{")
+    out.append(",\n".join(f"  {a.symbol}" for a in assets))
+    out.append("};")
+    out.append(f"const size_t {prefix}_file_sizes[{prefix}_file_count] = {{")
+    out.append(",\n".join(f"  {a.symbol}_len" for a in assets))
+    out.append("};")
+    out += preload_table(prefix, preload)
+    return "\n".join(out) + "\n"
+
+
+def mime_ids(assets: list[Asset]) -> list[int]:
+    return [mime_id(assets[a.alias_of].mime_path if a.alias_of is not None else a.mime_path) for a in assets]
+
+
+def render_device_image(
+    assets: list[Asset], listed: int, image: PackedImage, skip_interval: int, blob_align: int
+) -> bytes:
+    """Binary image for EmbedFSFS::begin(EmbedFSBlockDevice&); layout in EmbedFSImage.h."""
+    names = b"".join(a.path.encode("utf-8") + b"\0" for a in assets)
+    skip = struct.pack(f"<{len(image.skip)}I", *image.skip)
+    mime = bytes(mime_ids(assets))
+    index = names + image.toc + skip + mime
+    header_size = 4 * DEVICE_HEADER_WORDS
+    blob_offset = header_size + len(index)
+    blob_offset += (-blob_offset) % max(DEVICE_BLOB_ALIGN, blob_align)
+    header = struct.pack(
+        f"<{DEVICE_HEADER_WORDS}I",
+        DEVICE_MAGIC,
+        IMAGE_VERSION,
+        len(assets),
+        listed,
+        skip_interval,
+        len(names),
+        len(image.toc),
+        len(image.skip),
+        len(mime),
+        table_hash(),
+        blob_offset,
+        len(image.blob),
+        name_digest(assets) & 0xFFFFFFFF,
+        name_digest(assets) >> 32,
+    )
+    return header + index + b"\0" * (blob_offset - header_size - len(index)) + image.blob
+
+
+def render_packed(
+    prefix: str,
+    assets: list[Asset],
+    listed: int,
+    image: PackedImage,
+    skip_interval: int,
+    blob_align: int,
+    preload: list[str],
+    jobs: int,
+    asm: str = "",
+    hashes: list[tuple[int, int]] | None = None,
+    tags: list[tuple[str, list[int]]] | None = None,
+    names: NameDict | None = None,
+) -> str:
+    out = header_preamble("packed, asm" if asm else "packed", assets, include_image=True)
+    if asm:
+        out.append(f"// Defined in {asm}")
+        out.append(f'extern "C" const uint8_t {prefix}_blob[];')
+        out.append(f'extern "C" const uint8_t {prefix}_toc[];')
+    else:
+        out.append(f"alignas({blob_align}) const uint8_t {prefix}_blob[] PROGMEM = {{")
+        out.append(format_bytes_parallel(image.blob or b"\0", jobs))
+        out.append("};")
+        out.append("")
+        out.append(f"const uint8_t {prefix}_toc[] PROGMEM = {{")
+        out.append(format_bytes(image.toc or b"\0"))
+        out.append("};")
+    out.append("")
+    out.append(f"const uint32_t {prefix}_toc_skip[] PROGMEM = {{")
+    out.append(format_words(image.skip or [0, 0]))
+    out.append("};")
+    out.append("")
+    out.append(f"const uint8_t {prefix}_file_mime[] PROGMEM = {{")
+    out.append(format_ids(mime_ids(assets)))
+    out.append("};")
+    out.append("")
+    if hashes:
+        out.append(f"const uint32_t {prefix}_content_hash[] PROGMEM = {{")
+        out.append(format_words([w for h, i in hashes for w in (h >> 32, h & 0xFFFFFFFF, i)], per_line=6))
+        out.append("};")
+        out.append("")
+    if names:
+        out += count_constants(prefix, assets, listed)
+        out += name_dict_tables(prefix, names)
+    elif asm:
+        out += count_constants(prefix, assets, listed)
+        out.append(f'extern "C" const char* const {prefix}_file_names[{prefix}_file_count];')
+    else:
+        out += names_table(prefix, assets, listed)
+    out += preload_table(prefix, preload)
+    out += tag_tables(prefix, tags or [])
+    out.append("")
+    out.append(f"const fs::EmbedFSImage {prefix}_image = {{")
+    out.append(f"  {IMAGE_VERSION},")
+    out.append(f"  {prefix}_file_count,")
+    out.append("  nullptr," if names else f"  {prefix}_file_names,")
+    out.append(f"  {prefix}_blob,")
+    out.append(f"  {prefix}_toc,")
+    out.append(f"  {prefix}_toc_skip,")
+    out.append(f"  {skip_interval},")
+    out.append(f"  {listed},")
+    out.append(f"  {prefix}_file_mime,")
+    out.append(f"  0x{table_hash():08X},")
+    out.append(f"  {prefix}_preload," if preload else "  nullptr,")
+    out.append(f"  {prefix}_preload_count," if preload else "  0,")
+    out.append(f"  {prefix}_content_hash," if hashes else "  nullptr,")
+    out.append(f"  {len(hashes)}," if hashes else "  0,")
+    if tags:
+        out += [f"  {prefix}_tag_names,", f"  {prefix}_tag_starts,", f"  {prefix}_tag_entries,", f"  {prefix}_tag_count,"]
+    else:
+        out += ["  nullptr,", "  nullptr,", "  nullptr,", "  0,"]
+    if names:
+        out += [f"  {prefix}_name_dict,", f"  {prefix}_name_blocks,", f"  {names.block_size},"]
+        if names.ranks:
+            out += [f"  {prefix}_name_ranks,", f"  {prefix}_name_entries,"]
+        else:
+            out += ["  nullptr,", "  nullptr,"]
+    else:
+        out += ["  nullptr,", "  nullptr,", "  0,", "  nullptr,", "  nullptr,"]
+    out.append("  0," if names else f"  0x{name_digest(assets):016X}ull,")
+    out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def render_arrays_extern(prefix: str, assets: list[Asset], listed: int, preload: list[str], asm: str) -> str:
+    out = header_preamble("arrays, asm", assets, include_image=False)
+    out += count_constants(prefix, assets, listed)
+    out.append(f"// Defined in {asm}")
+    out.append(f'extern "C" const char* const {prefix}_file_names[{prefix}_file_count];')
+    out.append(f'extern "C" const uint8_t* const {prefix}_file_data[{prefix}_file_count];')
+    out.append(f'extern "C" const size_t {prefix}_file_sizes[{prefix}_file_count];')
+    out += preload_table(prefix, preload)
+    return "\n".join(out) + "\n"
+
+
+def _asm_string(text: str) -> str:
+    return '"' + "".join(c if c.isprintable() and c not in '"\\' else f"\\{ord(c):03o}" for c in text) + '"'
+
+
+def render_asm(
+    prefix: str,
+    assets: list[Asset],
+    image: PackedImage | None,
+    layout: DataLayout,
+    align: int,
+    section: str,
+    incbin: str,
+    pointer_size: int,
+    names: bool = True,
+) -> tuple[str, bytes]:
+    """Return (.S source, .incbin payload) defining the symbols the header declares extern.
+
+    Bytes are pulled in with .incbin so the assembler never parses them; only the small
+    name/pointer tables are written out as directives. Tables holding addresses go to
+    .data.rel.ro, which the dynamic linker may relocate in a PIE before making it read-only.
+    """
+    word = {2: ".2byte", 4: ".4byte", 8: ".8byte"}[pointer_size]
+    payload = bytearray()
+    out = ["/* Auto-generated by tools/embed_assets.py (asm) */", "", f'  .section {section},"a"']
+
+    def include(symbol: str, data: bytes, align: int = 4) -> int:
+        payload.extend(b"\0" * ((-len(payload)) % align))
+        offset = len(payload)
+        payload.extend(data)
+        out.extend([f"  .balign {align}", f"  .global {symbol}", f"{symbol}:"])
+        if data:
+            out.append(f'  .incbin "{incbin}", {offset}, {len(data)}')
+        return offset
+
+    if image is not None:
+        include(f"{prefix}_blob", image.blob, blob_alignment(align, layout))
+        include(f"{prefix}_toc", image.toc)
+    else:
+        bytes_symbol = f"{prefix}_file_bytes"
+        offsets: dict[int, int] = {}
+        # cache-line placement is relative to the symbol, so align it to a whole line
+        start = include(bytes_symbol, b"", max(4, layout.line if layout.hot else 0))
+        for index in layout.order:
+            data = assets[index].data
+            offset = start + place(len(payload) - start, len(data), 4, index in layout.hot, layout.line)
+            payload.extend(b"\0" * (offset - len(payload)))
+            offsets[index] = offset - start
+            payload.extend(data)
+        if len(payload) > start:
+            out.append(f'  .incbin "{incbin}", {start}, {len(payload) - start}')
+
+    if names:  # front-coded names live in the header
+        out += ["", '  .section .rodata,"a"']
+        for index, asset in enumerate(assets):
+            out.append(f".L{prefix}_name_{index}: .asciz {_asm_string(asset.path)}")
+        if image is None:
+            out += [f"  .balign {pointer_size}", f"  .global {prefix}_file_sizes", f"{prefix}_file_sizes:"]
+            out += [f"  {word} {len(asset.data)}" for asset in assets]
+        out += ["", '  .section .data.rel.ro,"aw"', f"  .balign {pointer_size}"]
+        out += [f"  .global {prefix}_file_names", f"{prefix}_file_names:"]
+        out += [f"  {word} .L{prefix}_name_{index}" for index in range(len(assets))]
+        if image is None:
+            out += [f"  .global {prefix}_file_data", f"{prefix}_file_data:"]
+            for asset_index, asset in enumerate(assets):
+                source = asset_index if asset.alias_of is None else asset.alias_of
+                out.append(f"  {word} {bytes_symbol} + {offsets[source]}")
+    # no executable stack on Linux hosts (ARM-style % works with every assembler)
+    out += ["", "#if defined(__linux__) && defined(__ELF__)", '  .section .note.GNU-stack,"",%progbits', "#endif"]
+    return "\n".join(out) + "\n", bytes(payload)
+
+
+def plain_index_bytes(assets: list[Asset], pointer_size: int) -> tuple[int, int]:
+    """Return (index bytes, alignment padding) for the arrays format."""
+    index = len(assets) * 2 * pointer_size
+    padding = sum((-max(len(a.data), 1)) % 4 for a in assets if a.alias_of is None)
+    return index, padding
+
+
+def footprint(
+    assets: list[Asset],
+    listed: int,
+    image: PackedImage | None,
+    emit: str,
+    pointer_size: int,
+    asm_payload: int,
+    hashes: list[tuple[int, int]],
+    tags: list[tuple[str, list[int]]],
+    name_dict: NameDict | None = None,
+    blob_align: int = 4,
+) -> dict:
+    """Flash by category as EmbedFSFS::footprint() reports it after mounting this output,
+    RAM of each lookup index, and one row per entry.
+
+    asm_payload: bytes of the .incbin payload for --emit asm arrays (its real padding),
+    else 0 (arrays padding is then estimated as each array rounded up to 4 bytes).
+    """
+    count = len(assets)
+    image_file = emit == "image"
+    name_bytes = sum(len(a.path.encode("utf-8")) + 1 for a in assets)
+    names = name_dict.flash() if name_dict else name_bytes + (0 if image_file else count * pointer_size)
+    rows = []
+    for index, asset in enumerate(assets):
+        source = index if asset.alias_of is None else asset.alias_of
+        row = {"path": asset.path, "size": len(asset.data)}
+        if asset.alias_of is not None:
+            row["alias_of"] = assets[asset.alias_of].path
+        if image is not None and source in image.placed:
+            offset, stored = image.placed[source]
+            row.update(placement="blob", offset=offset, stored=stored)
+        elif image is not None:
+            row.update(placement="inline", stored=len(asset.data))  # every entry keeps its own copy
+        else:
+            row.update(placement="array", stored=len(asset.data) if asset.alias_of is None else 0)
+        rows.append(row)
+    for h, index in hashes:
+        rows[index]["hash"] = f"{h:016x}"
+    for tag, entries in tags:
+        for index in entries:
+            rows[index].setdefault("tags", []).append(tag)
+
+    if image is None:
+        data = sum(len(a.data) for a in assets if a.alias_of is None)
+        padding = asm_payload - data if asm_payload else plain_index_bytes(assets, pointer_size)[1]
+        parts = {"pointers": count * pointer_size, "sizes": count * pointer_size}
+    else:
+        inline = sum(r["stored"] for r in rows if r["placement"] == "inline")
+        stored = sum(size for _, size in image.placed.values())
+        data = inline + stored
+        padding = len(image.blob) - stored
+        parts = {"toc": len(image.toc) - inline, "skip": 4 * len(image.skip), "mime": count}
+        if hashes:
+            parts["content_hash"] = 12 * len(hashes)
+        if tags:
+            tag_names = sum(len(tag.encode("utf-8")) + 1 + pointer_size for tag, _ in tags)
+            parts["tags"] = tag_names + 4 * (len(tags) + 1 + sum(len(entries) for _, entries in tags))
+        if image_file:
+            parts["header"] = 4 * DEVICE_HEADER_WORDS
+            index_end = 4 * DEVICE_HEADER_WORDS + name_bytes + len(image.toc) + 4 * len(image.skip) + count
+            padding += (-index_end) % max(DEVICE_BLOB_ALIGN, blob_align)  # up to blob_offset
+    index = sum(parts.values())
+    slot = 2 if count < 0xFFFF else 4
+    slots = 1
+    while slots < count + count // 2 + 1:
+        slots <<= 1
+    ram = {"lookup": {"linear": 0, "sorted": count * slot, "hash": slots * slot}}
+    if name_dict:
+        ram["lookup"] = {"front_coded": 0}
+    if image_file:
+        # names, TOC and MIME ids, the name pointers and the skip table are copied at begin()
+        ram["mount"] = name_bytes + len(image.toc) + count + count * pointer_size + 4 * len(image.skip)
+    return {
+        "format": "arrays" if image is None else "packed",
+        "emit": emit,
+        "pointer_size": pointer_size,
+        "files": count,
+        "listed": listed,
+        "flash": {
+            "data": data,
+            "padding": padding,
+            "names": names,
+            "index": index,
+            "total": data + padding + names + index,
+        },
+        "index": parts,
+        "ram": ram,
+        "entries": rows,
+    }
+
+
+def main() -> None:
+    args = parse_args()
+    root = pathlib.Path(args.assets)
+    if not root.is_dir():
+        sys.exit(f"assets directory not found: {root}")
+    if args.align < 1 or args.skip_interval < 1 or args.jobs < 1:
+        sys.exit("--align, --skip-interval and --jobs must be positive")
+    if args.align & (args.align - 1) or (args.profile_line or 0) & ((args.profile_line or 0) - 1):
+        sys.exit("--align and --profile-line must be powers of two")
+    if args.profile_line is not None and args.profile_line < 0:
+        sys.exit("--profile-line must be 0 or more")
+    if args.profile_line is not None and args.format == "arrays" and args.emit == "c":
+        # each file is its own C array, placed wherever the compiler puts it
+        sys.exit("--profile-line needs --format packed or --emit asm")
+    if args.emit == "asm" and args.pointer_size not in (2, 4, 8):
+        sys.exit("--emit asm needs --pointer-size 2, 4 or 8")
+    if args.emit == "image" and (args.format != "packed" or args.sparse_min_run):
+        sys.exit("--emit image needs --format packed and no --sparse-min-run")
+    if args.content_hash and (args.format != "packed" or args.emit == "image"):
+        sys.exit("--content-hash needs --format packed and --emit c or asm")
+    if args.name_blocks < 0 or (args.name_blocks and (args.format != "packed" or args.emit == "image")):
+        sys.exit("--name-blocks needs --format packed and --emit c or asm")
+    default_name = "assets.img" if args.emit == "image" else "assets_embed.h"
+    output = pathlib.Path(args.output) if args.output else root.parent / default_name
+    asm_output = output.with_suffix(".S")
+    bin_output = output.with_suffix(".bin")
+    incbin = args.incbin_path or pathlib.Path(os.path.relpath(bin_output, asm_output.parent)).as_posix()
+    asm_name = asm_output.name if args.emit == "asm" else ""
+    timer = StageTimer()
+    with timer.stage("collect"):
+        assets = collect_assets(root, args.prefix, args.jobs)
+    if not assets:
+        sys.exit(f"no files found in {root}")
+    manifest = load_manifest(args.manifest)
+    cache_dir = None if args.no_cache else pathlib.Path(args.cache_dir or root.parent / ".embedfs-cache")
+    with timer.stage("transform"):
+        assets = transform_assets(assets, manifest, args.prefix, cache_dir, args.jobs)
+        listed = add_aliases(assets, manifest)
+    layout = default_layout(assets)
+    if args.profile:
+        line = 32 if args.profile_line is None else args.profile_line
+        assets, layout = apply_profile(assets, listed, load_profile(args.profile), line)
+    if args.name_blocks:
+        assets, layout = name_order(assets, listed, layout)
+    preload = preload_paths(assets, manifest)
+    tags = tag_groups(assets, manifest)
+    if tags and (args.format != "packed" or args.emit == "image"):
+        sys.exit("manifest tags need --format packed and --emit c or asm")
+    hashes = content_hashes(assets) if args.content_hash else []
+    if hashes:
+        print(f"content hash: {len(hashes)} files, unique with {unique_hash_digits(hashes)} hex digits")
+
+    names = front_code_names(assets, args.name_blocks) if args.name_blocks else None
+    if names:
+        if names.ranks and len(assets) > 0xFFFF:
+            sys.exit("--name-blocks: more than 65535 files not in name order")
+        plain_names = sum(len(a.path.encode("utf-8")) + 1 for a in assets) + len(assets) * args.pointer_size
+        print(
+            f"names: front-coded {names.flash()} bytes in {len(names.blocks) - 1} blocks "
+            f"(plain {plain_names}{', with rank tables' if names.ranks else ''})"
+        )
+
+    data_bytes = sum(len(a.data) for a in assets if a.alias_of is None)
+    plain_index, plain_padding = plain_index_bytes(assets, args.pointer_size)
+    print(f"files: {len(assets)}, data: {data_bytes} bytes")
+    print(f"arrays index: {plain_index} bytes (+{plain_padding} bytes alignment padding)")
+
+    if args.format == "packed":
+        with timer.stage("pack"):
+            image = pack(assets, layout, args.align, args.skip_interval, args.inline_max, args.sparse_min_run, args.jobs)
+        inline_bytes = sum(len(a.data) for a in assets if len(a.data) <= args.inline_max and a.alias_of is None)
+        packed_index = len(image.toc) - inline_bytes + 4 * len(image.skip)
+        print(
+            f"packed index: {packed_index} bytes (toc {len(image.toc) - inline_bytes}, skip {4 * len(image.skip)})"
+            f", {inline_bytes} bytes inlined, blob {len(image.blob)} bytes"
+        )
+        plain_total = plain_index + plain_padding + data_bytes
+        packed_total = len(image.toc) + 4 * len(image.skip) + len(image.blob)
+        print(f"saved: {plain_total - packed_total} bytes (arrays {plain_total}, packed {packed_total})")
+        with timer.stage("render"):
+            if args.emit == "image":
+                content = render_device_image(
+                    assets, listed, image, args.skip_interval, blob_alignment(args.align, layout)
+                )
+            else:
+                content = render_packed(
+                    args.prefix,
+                    assets,
+                    listed,
+                    image,
+                    args.skip_interval,
+                    blob_alignment(args.align, layout),
+                    preload,
+                    args.jobs,
+                    asm_name,
+                    hashes,
+                    tags,
+                    names,
+                )
+    else:
+        image = None
+        with timer.stage("render"):
+            if asm_name:
+                content = render_arrays_extern(args.prefix, assets, listed, preload, asm_name)
+            else:
+                content = render_arrays(args.prefix, assets, listed, layout, preload, args.jobs)
+    if asm_name:
+        with timer.stage("asm"):
+            asm, payload = render_asm(
+                args.prefix, assets, image, layout, args.align, args.section, incbin, args.pointer_size, names is None
+            )
+    report = footprint(
+        assets,
+        listed,
+        image,
+        args.emit,
+        args.pointer_size,
+        len(payload) if asm_name and image is None else 0,
+        hashes,
+        tags,
+        names,
+        blob_alignment(args.align, layout),
+    )
+    flash = report["flash"]
+    print(
+        f"footprint: {flash['total']} bytes flash (data {flash['data']}, padding {flash['padding']}, "
+        f"names {flash['names']}, index {flash['index']}); "
+        + (
+            "lookup RAM 0 bytes (front-coded names)"
+            if names
+            else f"lookup RAM sorted {report['ram']['lookup']['sorted']}, hash {report['ram']['lookup']['hash']} bytes"
+        )
+    )
+
+    with timer.stage("write"):
+        if isinstance(content, bytes):
+            output.write_bytes(content)
+        else:
+            output.write_text(content, encoding="utf-8")
+        if asm_name:
+            asm_output.write_text(asm, encoding="utf-8")
+            bin_output.write_bytes(payload)
+        if args.report:
+            pathlib.Path(args.report).write_text(json.dumps(report, indent=2) + "\n", encoding="utf-8")
+    print(output)
+    if asm_name:
+        print(asm_output)
+        print(bin_output)
+    if args.report:
+        print(args.report)
+    print(timer.report(args.jobs))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,363 @@
+#!/usr/bin/env python3
+"""Generate src/embedfs_mime_table.h: a perfect hash from file extension to MIME type."""
+
+from __future__ import annotations
+
+import pathlib
+
+# Extension (lowercase, without the dot) -> content type.
+MIME_TYPES: dict[str, str] = {
+    # text / web
+    "html": "text/html",
+    "htm": "text/html",
+    "shtml": "text/html",
+    "xhtml": "application/xhtml+xml",
+    "css": "text/css",
+    "js": "text/javascript",
+    "mjs": "text/javascript",
+    "cjs": "text/javascript",
+    "json": "application/json",
+    "map": "application/json",
+    "jsonld": "application/ld+json",
+    "webmanifest": "application/manifest+json",
+    "txt": "text/plain",
+    "text": "text/plain",
+    "log": "text/plain",
+    "ini": "text/plain",
+    "conf": "text/plain",
+    "cfg": "text/plain",
+    "md": "text/markdown",
+    "markdown": "text/markdown",
+    "csv": "text/csv",
+    "tsv": "text/tab-separated-values",
+    "xml": "application/xml",
+    "xsl": "application/xml",
+    "xsd": "application/xml",
+    "dtd": "application/xml-dtd",
+    "rss": "application/rss+xml",
+    "atom": "application/atom+xml",
+    "yaml": "application/yaml",
+    "yml": "application/yaml",
+    "toml": "application/toml",
+    "ics": "text/calendar",
+    "vcf": "text/vcard",
+    "vtt": "text/vtt",
+    "srt": "application/x-subrip",
+    "rtf": "application/rtf",
+    "appcache": "text/cache-manifest",
+    "manifest": "text/cache-manifest",
+    "htc": "text/x-component",
+    "sgml": "text/sgml",
+    "c": "text/x-c",
+    "h": "text/x-c",
+    "cpp": "text/x-c",
+    "hpp": "text/x-c",
+    "ino": "text/x-c",
+    "py": "text/x-python",
+    "sh": "application/x-sh",
+    "lua": "text/x-lua",
+    "php": "application/x-httpd-php",
+    "wasm": "application/wasm",
+    "ts": "video/mp2t",
+    "tsx": "text/tsx",
+    "jsx": "text/jsx",
+    "vue": "text/plain",
+    "scss": "text/x-scss",
+    "sass": "text/x-sass",
+    "less": "text/css",
+    "coffee": "text/coffeescript",
+    "tmpl": "text/plain",
+    "mustache": "text/plain",
+    "hbs": "text/x-handlebars-template",
+    # images
+    "png": "image/png",
+    "apng": "image/apng",
+    "jpg": "image/jpeg",
+    "jpeg": "image/jpeg",
+    "jpe": "image/jpeg",
+    "jfif": "image/jpeg",
+    "pjpeg": "image/jpeg",
+    "pjp": "image/jpeg",
+    "gif": "image/gif",
+    "bmp": "image/bmp",
+    "dib": "image/bmp",
+    "ico": "image/x-icon",
+    "cur": "image/x-icon",
+    "svg": "image/svg+xml",
+    "svgz": "image/svg+xml",
+    "webp": "image/webp",
+    "avif": "image/avif",
+    "heic": "image/heic",
+    "heif": "image/heif",
+    "tif": "image/tiff",
+    "tiff": "image/tiff",
+    "jxl": "image/jxl",
+    "jp2": "image/jp2",
+    "psd": "image/vnd.adobe.photoshop",
+    "tga": "image/x-tga",
+    "pbm": "image/x-portable-bitmap",
+    "pgm": "image/x-portable-graymap",
+    "ppm": "image/x-portable-pixmap",
+    "pnm": "image/x-portable-anymap",
+    "xbm": "image/x-xbitmap",
+    "xpm": "image/x-xpixmap",
+    "wbmp": "image/vnd.wap.wbmp",
+    "dds": "image/vnd-ms.dds",
+    "ktx": "image/ktx",
+    "ktx2": "image/ktx2",
+    "exr": "image/x-exr",
+    "hdr": "image/vnd.radiance",
+    "qoi": "image/qoi",
+    # audio
+    "mp3": "audio/mpeg",
+    "mpga": "audio/mpeg",
+    "wav": "audio/wav",
+    "wave": "audio/wav",
+    "ogg": "audio/ogg",
+    "oga": "audio/ogg",
+    "opus": "audio/opus",
+    "flac": "audio/flac",
+    "aac": "audio/aac",
+    "m4a": "audio/mp4",
+    "mid": "audio/midi",
+    "midi": "audio/midi",
+    "weba": "audio/webm",
+    "aif": "audio/aiff",
+    "aiff": "audio/aiff",
+    "au": "audio/basic",
+    "snd": "audio/basic",
+    "amr": "audio/amr",
+    "caf": "audio/x-caf",
+    "wma": "audio/x-ms-wma",
+    "mka": "audio/x-matroska",
+    "pcm": "audio/L16",
+    "raw": "application/octet-stream",
+    # video
+    "mp4": "video/mp4",
+    "m4v": "video/mp4",
+    "mpg": "video/mpeg",
+    "mpeg": "video/mpeg",
+    "webm": "video/webm",
+    "ogv": "video/ogg",
+    "mov": "video/quicktime",
+    "avi": "video/x-msvideo",
+    "mkv": "video/x-matroska",
+    "wmv": "video/x-ms-wmv",
+    "flv": "video/x-flv",
+    "3gp": "video/3gpp",
+    "3g2": "video/3gpp2",
+    "m3u8": "application/vnd.apple.mpegurl",
+    "m3u": "audio/x-mpegurl",
+    "mpd": "application/dash+xml",
+    "h264": "video/h264",
+    "mjpg": "video/x-motion-jpeg",
+    "mjpeg": "video/x-motion-jpeg",
+    # fonts
+    "woff": "font/woff",
+    "woff2": "font/woff2",
+    "ttf": "font/ttf",
+    "otf": "font/otf",
+    "ttc": "font/collection",
+    "eot": "application/vnd.ms-fontobject",
+    "pfb": "application/x-font-type1",
+    "bdf": "application/x-font-bdf",
+    "pcf": "application/x-font-pcf",
+    # documents
+    "pdf": "application/pdf",
+    "ps": "application/postscript",
+    "eps": "application/postscript",
+    "doc": "application/msword",
+    "docx": "application/vnd.openxmlformats-officedocument.wordprocessingml.document",
+    "xls": "application/vnd.ms-excel",
+    "xlsx": "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
+    "ppt": "application/vnd.ms-powerpoint",
+    "pptx": "application/vnd.openxmlformats-officedocument.presentationml.presentation",
+    "odt": "application/vnd.oasis.opendocument.text",
+    "ods": "application/vnd.oasis.opendocument.spreadsheet",
+    "odp": "application/vnd.oasis.opendocument.presentation",
+    "epub": "application/epub+zip",
+    "tex": "application/x-tex",
+    # archives / binary
+    "zip": "application/zip",
+    "gz": "application/gzip",
+    "tgz": "application/gzip",
+    "tar": "application/x-tar",
+    "bz2": "application/x-bzip2",
+    "xz": "application/x-xz",
+    "7z": "application/x-7z-compressed",
+    "rar": "application/vnd.rar",
+    "zst": "application/zstd",
+    "br": "application/x-brotli",
+    "lz4": "application/x-lz4",
+    "jar": "application/java-archive",
+    "apk": "application/vnd.android.package-archive",
+    "bin": "application/octet-stream",
+    "dat": "application/octet-stream",
+    "img": "application/octet-stream",
+    "iso": "application/x-iso9660-image",
+    "exe": "application/vnd.microsoft.portable-executable",
+    "dll": "application/vnd.microsoft.portable-executable",
+    "elf": "application/x-elf",
+    "hex": "text/plain",
+    "dfu": "application/octet-stream",
+    "uf2": "application/octet-stream",
+    "deb": "application/vnd.debian.binary-package",
+    "rpm": "application/x-rpm",
+    "dmg": "application/x-apple-diskimage",
+    "swf": "application/x-shockwave-flash",
+    # data / misc
+    "pem": "application/x-pem-file",
+    "crt": "application/x-x509-ca-cert",
+    "cer": "application/pkix-cert",
+    "der": "application/x-x509-ca-cert",
+    "key": "application/octet-stream",
+    "p12": "application/x-pkcs12",
+    "pfx": "application/x-pkcs12",
+    "csr": "application/pkcs10",
+    "sig": "application/pgp-signature",
+    "asc": "application/pgp-signature",
+    "cbor": "application/cbor",
+    "msgpack": "application/msgpack",
+    "pb": "application/x-protobuf",
+    "proto": "text/plain",
+    "sqlite": "application/vnd.sqlite3",
+    "db": "application/octet-stream",
+    "gltf": "model/gltf+json",
+    "glb": "model/gltf-binary",
+    "obj": "model/obj",
+    "stl": "model/stl",
+    "3mf": "model/3mf",
+    "usdz": "model/vnd.usdz+zip",
+    "geojson": "application/geo+json",
+    "gpx": "application/gpx+xml",
+    "kml": "application/vnd.google-earth.kml+xml",
+    "kmz": "application/vnd.google-earth.kmz",
+    "torrent": "application/x-bittorrent",
+}
+
+# Must match src/EmbedFSMime.cpp
+DEFAULT_TYPE = "application/octet-stream"  # MIME id 0
+MAX_EXTENSION = 15
+TABLE_BITS = 9  # 512 slots
+BUCKET_COUNT = 128
+
+
+def fnv1a(text: str, seed: int) -> int:
+    h = (0x811C9DC5 ^ (seed * 0x01000193)) & 0xFFFFFFFF
+    for ch in text.encode("ascii"):
+        h ^= ch
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def type_names() -> list[str]:
+    """Distinct content types; MIME id n (n >= 1) is type_names()[n - 1]."""
+    return sorted(set(MIME_TYPES.values()) - {DEFAULT_TYPE})
+
+
+def type_id(content_type: str) -> int:
+    return 0 if content_type == DEFAULT_TYPE else type_names().index(content_type) + 1
+
+
+def table_hash() -> int:
+    """Hash of the id -> type assignment; images record it so ids from another table are
+    not trusted (EmbedFSMime::tableHash())."""
+    return fnv1a("\n".join([DEFAULT_TYPE] + type_names()), 0)
+
+
+def mime_id(path: str) -> int:
+    """Return the MIME id for path (0 when unknown), matching EmbedFSMime::idFromPath."""
+    name = path.rsplit("/", 1)[-1].lower()
+    if "." not in name:
+        return 0
+    ext = name.rsplit(".", 1)[1]
+    if ext not in MIME_TYPES or len(ext) > MAX_EXTENSION:
+        return 0
+    return type_id(MIME_TYPES[ext])
+
+
+def build() -> tuple[list[int], list[int]]:
+    """Return (bucket displacement seeds, slot -> extension index + 1)."""
+    extensions = [e for e in MIME_TYPES if len(e) <= MAX_EXTENSION]
+    size = 1 << TABLE_BITS
+    buckets: list[list[int]] = [[] for _ in range(BUCKET_COUNT)]
+    for index, ext in enumerate(extensions):
+        buckets[fnv1a(ext, 0) % BUCKET_COUNT].append(index)
+    seeds = [0] * BUCKET_COUNT
+    slots = [0] * size
+    for bucket in sorted(range(BUCKET_COUNT), key=lambda b: -len(buckets[b])):
+        members = buckets[bucket]
+        if not members:
+            continue
+        for seed in range(1, 256):
+            placed = {fnv1a(extensions[i], seed) & (size - 1) for i in members}
+            if len(placed) == len(members) and all(slots[p] == 0 for p in placed):
+                for i in members:
+                    slots[fnv1a(extensions[i], seed) & (size - 1)] = i + 1
+                seeds[bucket] = seed
+                break
+        else:
+            raise SystemExit(f"no displacement seed for bucket {bucket}")
+    return seeds, slots
+
+
+def render() -> str:
+    extensions = [e for e in MIME_TYPES if len(e) <= MAX_EXTENSION]
+    types = type_names()
+    seeds, slots = build()
+
+    def rows(values: list[str], per_line: int) -> str:
+        return ",\n".join(
+            "    " + ", ".join(values[i : i + per_line]) for i in range(0, len(values), per_line)
+        )
+
+    out = [
+        "/* Auto-generated by tools/gen_mime_table.py - do not edit manually */",
+        "#ifndef EMBEDFS_MIME_TABLE_H",
+        "#define EMBEDFS_MIME_TABLE_H",
+        "",
+        f"#define EMBEDFS_MIME_TABLE_BITS {TABLE_BITS}",
+        f"#define EMBEDFS_MIME_BUCKETS {BUCKET_COUNT}",
+        f"#define EMBEDFS_MIME_MAX_EXTENSION {MAX_EXTENSION}",
+        f"#define EMBEDFS_MIME_TYPE_COUNT {len(types)}",
+        "// FNV-1a of the content types in id order, recorded in images next to their MIME ids",
+        f"#define EMBEDFS_MIME_TABLE_HASH 0x{table_hash():08X}u",
+        "",
+        "// Displacement seed per first-level bucket",
+        "static const uint8_t kMimeSeeds[EMBEDFS_MIME_BUCKETS] = {",
+        rows([str(s) for s in seeds], 16),
+        "};",
+        "",
+        "// Hash slot -> extension index + 1 (0 = empty)",
+        "static const uint8_t kMimeSlots[1 << EMBEDFS_MIME_TABLE_BITS] = {",
+        rows([str(s) for s in slots], 16),
+        "};",
+        "",
+        "static const char *const kMimeExtensions[] = {",
+        rows([f'"{e}"' for e in extensions], 8),
+        "};",
+        "",
+        "// Extension index -> MIME id",
+        "static const uint8_t kMimeExtensionIds[] = {",
+        rows([str(type_id(MIME_TYPES[e])) for e in extensions], 16),
+        "};",
+        "",
+        "// MIME id -> content type (id 0 is unknown)",
+        "static const char *const kMimeTypes[EMBEDFS_MIME_TYPE_COUNT + 1] = {",
+        ",\n".join(f'    "{t}"' for t in [DEFAULT_TYPE] + types),
+        "};",
+        "",
+        "#endif // EMBEDFS_MIME_TABLE_H",
+    ]
+    return "\n".join(out) + "\n"
+
+
+def main() -> None:
+    path = pathlib.Path(__file__).resolve().parent.parent / "src" / "embedfs_mime_table.h"
+    path.write_text(render(), encoding="utf-8")
+    print(f"{len(MIME_TYPES)} extensions, {len(type_names())} types")
+    print(path)
+
+
+if __name__ == "__main__":
+    main()